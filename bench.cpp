@@ -0,0 +1,510 @@
+/**
+ * @file bench.cpp
+ * @brief Benchmarks for the `bigint` class, timing every operation over a range of operand sizes.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * Reports ns/op, heap allocations and bytes per operation, and throughput in operand digits per
+ * second. Results can be written as CSV or JSON and compared against a saved CSV baseline.
+ *
+ */
+#include "bigint.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+// GCC pairs the replaced operator new with free() once operator delete is inlined and warns,
+// although both sides use malloc and free
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<uint64_t> allocation_count(0); ///< Heap allocations since the start of the program.
+static std::atomic<uint64_t> allocation_bytes(0); ///< Bytes requested from the heap since the start of the program.
+
+/**
+ * @brief Counting replacement of the global allocation function.
+ *
+ * @param size Number of bytes.
+ * @return Pointer to the allocated memory.
+ * @throws std::bad_alloc if the allocation fails.
+ */
+void *operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+/**
+ * @brief Counting replacement of the global array allocation function.
+ *
+ * @param size Number of bytes.
+ * @return Pointer to the allocated memory.
+ */
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+/**
+ * @brief Replacement of the global deallocation function matching the counting `operator new`.
+ *
+ * @param memory Memory returned by `operator new`.
+ */
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+/**
+ * @brief Measurement of one operation at one operand size.
+ *
+ */
+struct bench_result
+{
+    std::string operation;     ///< Name of the operation.
+    uint64_t digits;           ///< Digits of the operands.
+    uint64_t iterations;       ///< Number of timed calls.
+    double ns_per_op;          ///< Mean wall time per call in nanoseconds.
+    double allocations_per_op; ///< Mean heap allocations per call, including the result.
+    double bytes_per_op;       ///< Mean bytes allocated per call, including the result.
+    double digits_per_second;  ///< Operand digits processed per second.
+};
+
+/**
+ * @brief Command-line settings of a benchmark run.
+ *
+ */
+struct bench_options
+{
+    std::vector<uint64_t> sizes = {1, 10, 100, 1000, 10000, 100000}; ///< Operand sizes in digits.
+    std::vector<std::string> operations;                             ///< Operations to run; all if empty.
+    double min_time = 0.2;                                           ///< Seconds to repeat each measurement for.
+    double max_time = 2.0;                                           ///< Larger sizes are skipped once one call is predicted to take longer.
+    double threshold = 0.1;                                          ///< Relative slowdown against the baseline reported as a regression.
+    std::string csv_path;                                            ///< CSV output file, if any.
+    std::string json_path;                                           ///< JSON output file, if any.
+    std::string baseline_path;                                       ///< CSV baseline to compare against, if any.
+};
+
+/**
+ * @brief Operands shared by all operations at one size.
+ *
+ */
+struct bench_operands
+{
+    std::string text;                        ///< Decimal string of `a`.
+    bigint a;                                ///< Random operand with the full number of digits.
+    bigint b;                                ///< Second random operand with the full number of digits.
+    bigint half;                             ///< Random operand with half the digits, used as divisor.
+    std::unique_ptr<bigint_divisor> divisor; ///< `half` prepared once, outside the timed calls.
+    bigint small;                            ///< Random 18-digit operand, a factor of the short products added to `counter`.
+    bigint counter;                          ///< Copy of `a` that is incremented and accumulated into in place.
+    uint64_t exponent;                       ///< Exponent with `7^exponent` about as long as the operands.
+};
+
+/**
+ * @brief Benchmarked operation.
+ *
+ */
+struct bench_operation
+{
+    std::string name;                                        ///< Name used in the output and in `--ops`.
+    double growth;                                           ///< Exponent of the expected cost in the operand size, used to predict the next size.
+    uint64_t max_digits;                                     ///< Largest meaningful operand size.
+    std::function<void(bench_operands &, bigint &)> kernel; ///< One call of the operation; stores a result in the sink.
+};
+
+/**
+ * @brief Random decimal string without a leading zero.
+ *
+ * @param digits Number of digits.
+ * @param mt64 Random engine.
+ * @return The string.
+ */
+std::string random_digits(uint64_t digits, std::mt19937_64 &mt64)
+{
+    std::string s(digits, '0');
+    for (uint64_t i = 0; i < digits; i++)
+    {
+        s[i] = static_cast<char>('0' + mt64() % 10);
+    }
+    s[0] = static_cast<char>('1' + mt64() % 9);
+    return s;
+}
+
+/**
+ * @brief The benchmarked operations.
+ *
+ * @return The operations in output order.
+ */
+std::vector<bench_operation> operations()
+{
+    std::vector<bench_operation> list;
+    list.push_back({"construct_string", 1.0, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = bigint(x.text); }});
+    list.push_back({"construct_int", 1.0, 18, [](bench_operands &x, bigint &sink)
+                    { sink = bigint(static_cast<int64_t>(x.text.size() * 7919 % 1000000007)); }});
+    list.push_back({"print", 1.0, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    {
+                        std::ostringstream os;
+                        os << x.a;
+                        sink = bigint(static_cast<int64_t>(os.str().size()));
+                    }});
+    list.push_back({"add", 1.0, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = x.a + x.b; }});
+    list.push_back({"sub", 1.0, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = x.a - x.b; }});
+    list.push_back({"mul", 1.6, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = x.a * x.b; }});
+    list.push_back({"addmul", 1.6, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    {
+                        sink = x.b;
+                        sink.addmul(x.a, x.b);
+                    }});
+    list.push_back({"add_mul", 1.6, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    {
+                        sink = x.b;
+                        sink += x.a * x.b;
+                    }});
+    list.push_back({"addmul_short", 1.0, UINT64_MAX, [](bench_operands &x, bigint &)
+                    { x.counter.addmul(x.small, x.small); }});
+    list.push_back({"add_mul_short", 1.0, UINT64_MAX, [](bench_operands &x, bigint &)
+                    { x.counter += x.small * x.small; }});
+    list.push_back({"square", 1.6, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = x.a.square(); }});
+    list.push_back({"compare", 1.0, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = bigint(x.a < x.b ? 1 : 0); }});
+    list.push_back({"increment", 1.0, UINT64_MAX, [](bench_operands &x, bigint &)
+                    { ++x.counter; }});
+    list.push_back({"divmod", 2.0, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    {
+                        std::pair<bigint, bigint> result = x.divisor->divmod(x.a);
+                        sink = result.first + result.second;
+                    }});
+    list.push_back({"pow", 1.6, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = pow(bigint(7), x.exponent); }});
+    list.push_back({"gcd", 2.0, UINT64_MAX, [](bench_operands &x, bigint &sink)
+                    { sink = gcd(x.a, x.b); }});
+    return list;
+}
+
+/**
+ * @brief Times one operation at one size.
+ *
+ * One untimed call warms up the caches and estimates the cost; the operation is then repeated
+ * until `min_time` seconds have passed, at least once.
+ *
+ * @param operation The operation.
+ * @param operands The operands.
+ * @param digits Digits of the operands.
+ * @param min_time Seconds to repeat the operation for.
+ * @return The measurement.
+ */
+bench_result measure(const bench_operation &operation, bench_operands &operands, uint64_t digits, double min_time)
+{
+    bigint sink;
+    auto start = std::chrono::steady_clock::now();
+    operation.kernel(operands, sink);
+    double once = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t iterations = once >= min_time ? 1 : static_cast<uint64_t>(min_time / std::max(once, 1e-9)) + 1;
+
+    uint64_t count_before = allocation_count.load();
+    uint64_t bytes_before = allocation_bytes.load();
+    start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        operation.kernel(operands, sink);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bench_result result;
+    result.operation = operation.name;
+    result.digits = digits;
+    result.iterations = iterations;
+    result.ns_per_op = elapsed * 1e9 / static_cast<double>(iterations);
+    result.allocations_per_op = static_cast<double>(allocation_count.load() - count_before) / static_cast<double>(iterations);
+    result.bytes_per_op = static_cast<double>(allocation_bytes.load() - bytes_before) / static_cast<double>(iterations);
+    result.digits_per_second = static_cast<double>(digits) * 1e9 / result.ns_per_op;
+    return result;
+}
+
+/**
+ * @brief Runs every selected operation over every size.
+ *
+ * A size is skipped for an operation when the last measured time, scaled by the operation's
+ * growth exponent, predicts one call longer than `max_time`.
+ *
+ * @param options The settings.
+ * @return The measurements.
+ */
+std::vector<bench_result> run(const bench_options &options)
+{
+    std::vector<bench_operation> selected;
+    for (const bench_operation &operation : operations())
+    {
+        bool wanted = options.operations.empty();
+        for (const std::string &name : options.operations)
+        {
+            wanted = wanted || name == operation.name;
+        }
+        if (wanted)
+            selected.push_back(operation);
+    }
+
+    std::mt19937_64 mt64(20261019);
+    std::map<std::string, std::pair<uint64_t, double>> last;
+    std::vector<bench_result> results;
+    for (uint64_t digits : options.sizes)
+    {
+        std::vector<const bench_operation *> due;
+        for (const bench_operation &operation : selected)
+        {
+            if (digits > operation.max_digits)
+                continue;
+            auto previous = last.find(operation.name);
+            if (previous != last.end())
+            {
+                double scale = static_cast<double>(digits) / static_cast<double>(previous->second.first);
+                double predicted = previous->second.second * 1e-9 * std::pow(scale, operation.growth);
+                if (predicted > options.max_time)
+                {
+                    std::cerr << operation.name << " skipped at " << digits << " digits (predicted " << predicted << " s per call)" << std::endl;
+                    continue;
+                }
+            }
+            due.push_back(&operation);
+        }
+        if (due.empty())
+            continue;
+
+        bench_operands operands;
+        operands.text = random_digits(digits, mt64);
+        operands.a = bigint(operands.text);
+        operands.b = bigint(random_digits(digits, mt64));
+        operands.half = bigint(random_digits(std::max<uint64_t>(digits / 2, 1), mt64));
+        operands.divisor.reset(new bigint_divisor(operands.half));
+        operands.small = bigint(random_digits(18, mt64));
+        operands.counter = operands.a;
+        operands.exponent = static_cast<uint64_t>(static_cast<double>(digits) / std::log10(7.0)) + 1;
+
+        for (const bench_operation *operation : due)
+        {
+            bench_result result = measure(*operation, operands, digits, options.min_time);
+            last[operation->name] = std::make_pair(digits, result.ns_per_op);
+            results.push_back(result);
+            std::cout << result.operation << '\t' << result.digits << '\t' << result.ns_per_op << " ns/op\t"
+                      << result.allocations_per_op << " allocs/op\t" << result.bytes_per_op << " B/op\t"
+                      << result.digits_per_second << " digits/s" << std::endl;
+        }
+    }
+    return results;
+}
+
+/**
+ * @brief Writes the measurements as CSV with a header line.
+ *
+ * @param path The output file.
+ * @param results The measurements.
+ */
+void write_csv(const std::string &path, const std::vector<bench_result> &results)
+{
+    std::ofstream out(path);
+    out << "operation,digits,iterations,ns_per_op,allocations_per_op,bytes_per_op,digits_per_second\n";
+    for (const bench_result &r : results)
+    {
+        out << r.operation << ',' << r.digits << ',' << r.iterations << ',' << r.ns_per_op << ','
+            << r.allocations_per_op << ',' << r.bytes_per_op << ',' << r.digits_per_second << '\n';
+    }
+}
+
+/**
+ * @brief Writes the measurements as a JSON array of objects.
+ *
+ * @param path The output file.
+ * @param results The measurements.
+ */
+void write_json(const std::string &path, const std::vector<bench_result> &results)
+{
+    std::ofstream out(path);
+    out << "[\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const bench_result &r = results[i];
+        out << "  {\"operation\": \"" << r.operation << "\", \"digits\": " << r.digits << ", \"iterations\": " << r.iterations
+            << ", \"ns_per_op\": " << r.ns_per_op << ", \"allocations_per_op\": " << r.allocations_per_op
+            << ", \"bytes_per_op\": " << r.bytes_per_op << ", \"digits_per_second\": " << r.digits_per_second << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+}
+
+/**
+ * @brief Compares the measurements with a CSV baseline written by an earlier run.
+ *
+ * @param path The baseline file.
+ * @param results The new measurements.
+ * @param threshold Relative slowdown reported as a regression.
+ * @return Number of regressions.
+ */
+size_t compare_baseline(const std::string &path, const std::vector<bench_result> &results, double threshold)
+{
+    std::ifstream in(path);
+    if (!in.is_open())
+    {
+        throw std::invalid_argument("bench::compare_baseline : Unable to open baseline " + path + ".");
+    }
+    std::map<std::pair<std::string, uint64_t>, double> baseline;
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        std::string operation, digits, iterations, ns_per_op;
+        if (std::getline(fields, operation, ',') && std::getline(fields, digits, ',') &&
+            std::getline(fields, iterations, ',') && std::getline(fields, ns_per_op, ','))
+            baseline[std::make_pair(operation, std::stoull(digits))] = std::stod(ns_per_op);
+    }
+
+    size_t regressions = 0;
+    std::cout << "Comparison with " << path << '\n';
+    for (const bench_result &r : results)
+    {
+        auto old = baseline.find(std::make_pair(r.operation, r.digits));
+        if (old == baseline.end())
+            continue;
+        double ratio = r.ns_per_op / old->second;
+        const char *verdict = ratio > 1 + threshold ? "REGRESSION" : ratio < 1 - threshold ? "improved" : "unchanged";
+        regressions += ratio > 1 + threshold;
+        std::cout << r.operation << '\t' << r.digits << '\t' << old->second << " -> " << r.ns_per_op << " ns/op\t"
+                  << ratio << "x\t" << verdict << '\n';
+    }
+    std::cout << regressions << " regressions" << std::endl;
+    return regressions;
+}
+
+/**
+ * @brief Splits a comma-separated list.
+ *
+ * @param list The list.
+ * @return The items.
+ */
+std::vector<std::string> split(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ','))
+    {
+        if (!item.empty())
+            items.push_back(item);
+    }
+    return items;
+}
+
+/**
+ * @brief Parses the command line.
+ *
+ * @param argc Number of arguments.
+ * @param argv The arguments.
+ * @return The settings.
+ * @throws std::invalid_argument for an unknown option or a missing value.
+ */
+bench_options parse(int argc, char **argv)
+{
+    bench_options options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+            throw std::invalid_argument("bench::parse : Missing value for " + option + ".");
+        std::string value = argv[++i];
+        if (option == "--sizes")
+        {
+            options.sizes.clear();
+            for (const std::string &size : split(value))
+            {
+                options.sizes.push_back(std::stoull(size));
+            }
+        }
+        else if (option == "--max-digits")
+        {
+            options.sizes.clear();
+            for (uint64_t size = 1; size <= std::stoull(value); size *= 10)
+            {
+                options.sizes.push_back(size);
+            }
+        }
+        else if (option == "--ops")
+            options.operations = split(value);
+        else if (option == "--min-time")
+            options.min_time = std::stod(value);
+        else if (option == "--max-time")
+            options.max_time = std::stod(value);
+        else if (option == "--threshold")
+            options.threshold = std::stod(value);
+        else if (option == "--csv")
+            options.csv_path = value;
+        else if (option == "--json")
+            options.json_path = value;
+        else if (option == "--baseline")
+            options.baseline_path = value;
+        else
+            throw std::invalid_argument("bench::parse : Unknown option " + option + ".");
+    }
+    return options;
+}
+
+/**
+ * @brief Main entry point for the benchmarks.
+ *
+ * @param argc Number of arguments.
+ * @param argv The arguments.
+ * @return 0 on success, 1 if the baseline comparison found regressions, 2 on invalid usage.
+ */
+int main(int argc, char **argv)
+{
+    try
+    {
+        bench_options options = parse(argc, argv);
+        std::vector<bench_result> results = run(options);
+        if (!options.csv_path.empty())
+            write_csv(options.csv_path, results);
+        if (!options.json_path.empty())
+            write_json(options.json_path, results);
+        if (!options.baseline_path.empty() && compare_baseline(options.baseline_path, results, options.threshold) > 0)
+            return 1;
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 2;
+    }
+    return 0;
+}
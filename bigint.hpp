@@ -14,714 +14,7459 @@
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
-class bigint
+#include <iterator>
+#include <limits>
+#include <utility>
+#include <tuple>
+#include <cmath>
+#include <thread>
+#include <type_traits>
+#include <memory>
+#include <random>
+#if defined(BIGINT_SHARED_STORAGE) || defined(BIGINT_INSTRUMENT)
+#include <atomic>
+#endif
+#ifdef BIGINT_INSTRUMENT
+#include <mutex>
+#endif
+
+/**
+ * @brief Expands to `constexpr` when the standard library supports transient
+ * constant-evaluated allocation in `std::vector` and `std::string` (C++20),
+ * and to nothing otherwise so the header keeps building in older modes.
+ * Shared storage uses an atomic reference count and always disables it, and so do the
+ * run-time thresholds of `BIGINT_TUNE`.
+ * `BIGINT_IS_CONSTANT_EVALUATED()` is `std::is_constant_evaluated()` in the first case and
+ * `false` otherwise.
+ *
+ */
+#if defined(__cpp_lib_constexpr_vector) && defined(__cpp_lib_constexpr_string) && __cpp_lib_constexpr_vector >= 201907L && __cpp_lib_constexpr_string >= 201907L && !defined(BIGINT_SHARED_STORAGE) && !defined(BIGINT_TUNE)
+#define BIGINT_CONSTEXPR constexpr
+#define BIGINT_HAS_CONSTEXPR 1
+#define BIGINT_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#else
+#define BIGINT_CONSTEXPR
+#define BIGINT_HAS_CONSTEXPR 0
+#define BIGINT_IS_CONSTANT_EVALUATED() false
+#endif
+
+/**
+ * @brief Thresholds measured on the host by `tune.cpp`, used when it has written them next to this header.
+ * Values defined on the command line take precedence, and the defaults below apply when there is no such file.
+ *
+ */
+#if defined(__has_include)
+#if __has_include("bigint_thresholds.hpp")
+#include "bigint_thresholds.hpp"
+#endif
+#endif
+
+/**
+ * @brief Operand length in digits from which `bigint::square()` switches from schoolbook to Karatsuba squaring.
+ *
+ */
+#ifndef BIGINT_SQR_KARATSUBA_THRESHOLD
+#define BIGINT_SQR_KARATSUBA_THRESHOLD 384
+#endif
+
+/**
+ * @brief Length in digits of the shorter operand from which `operator*` switches from schoolbook to Karatsuba multiplication.
+ *
+ */
+#ifndef BIGINT_MUL_KARATSUBA_THRESHOLD
+#define BIGINT_MUL_KARATSUBA_THRESHOLD 192
+#endif
+
+#ifdef BIGINT_TUNE
+/**
+ * @brief Run-time Karatsuba thresholds, enabled with `-DBIGINT_TUNE` so `tune.cpp` can search for the
+ * crossovers without recompiling. Both start at the compile-time values. Values below 2 never terminate.
+ *
+ */
+class bigint_tune
 {
-private:
+public:
     /**
-     * @brief
+     * @brief Operand length in digits from which `bigint::square()` uses Karatsuba squaring.
+     *
+     * @return Reference to the threshold.
+     */
+    static size_t &sqr_karatsuba()
+    {
+        static size_t threshold = BIGINT_SQR_KARATSUBA_THRESHOLD;
+        return threshold;
+    }
+    /**
+     * @brief Length in digits of the shorter operand from which `operator*` uses Karatsuba multiplication.
+     *
+     * @return Reference to the threshold.
+     */
+    static size_t &mul_karatsuba()
+    {
+        static size_t threshold = BIGINT_MUL_KARATSUBA_THRESHOLD;
+        return threshold;
+    }
+};
+#undef BIGINT_SQR_KARATSUBA_THRESHOLD
+#undef BIGINT_MUL_KARATSUBA_THRESHOLD
+#define BIGINT_SQR_KARATSUBA_THRESHOLD (bigint_tune::sqr_karatsuba())
+#define BIGINT_MUL_KARATSUBA_THRESHOLD (bigint_tune::mul_karatsuba())
+#endif
+
+#ifdef BIGINT_INSTRUMENT
+/**
+ * @brief Operation counters, operand size histograms and trace hooks, enabled with `-DBIGINT_INSTRUMENT`.
+ *
+ * Every thread counts into its own counters, which are registered once and merged on demand by
+ * `collect()`; the counters of finished threads are folded into a shared total when they exit.
+ * Counting never takes a lock. Without `BIGINT_INSTRUMENT` the recording macros expand to
+ * nothing and this class is not declared.
+ */
+class bigint_instrument
+{
+public:
+    /**
+     * @brief Counted operations and algorithm tiers.
      *
      */
-    std::vector<uint8_t> digits; ///< Digits of the number stored in reverse order (least significant digit first).
-    bool is_negative;            ///< Sign of the number (true for negative, false for non-negative).
+    enum event : size_t
+    {
+        add,            ///< `operator+`.
+        sub,            ///< `operator-`.
+        mul,            ///< `operator*`.
+        square,         ///< `bigint::square()`.
+        div,            ///< Division by a `bigint_divisor`.
+        pow,            ///< `pow`.
+        gcd,            ///< `gcd` and `gcdext`.
+        shift,          ///< `<<` and `>>` by a bit count.
+        bitwise,        ///< `&`, `|` and `^`.
+        compare,        ///< `operator<`.
+        parse,          ///< Construction from a string.
+        print,          ///< Output to a stream.
+        copy,           ///< Copy construction and copy assignment.
+        get_digits,     ///< Copies returned by `get_digits()`.
+        mul_schoolbook, ///< Schoolbook products, including those inside Karatsuba.
+        mul_karatsuba,  ///< Karatsuba splits of a product.
+        sqr_schoolbook, ///< Schoolbook squares, including those inside Karatsuba.
+        sqr_karatsuba,  ///< Karatsuba splits of a square.
+        event_count     ///< Number of events.
+    };
+
+    static const size_t buckets = 65; ///< Histogram buckets: bucket `b` counts operands whose digit count has bit length `b`, i.e. `2^(b-1) <= digits < 2^b`; bucket 0 counts empty operands.
 
     /**
-     * @brief Gets a digit at a specific index.
+     * @brief Trace hook called when an instrumented span begins and ends.
      *
-     * @param n Index of the digit.
-     * @return The digit at the specified index or 0 if out of bounds.
+     * @param operation Name of the event.
+     * @param digits Operand size in digits.
+     * @param begin True when the span begins, false when it ends.
      */
-    uint8_t get_digit(const uint64_t n) const;
+    typedef void (*trace_callback)(const char *operation, uint64_t digits, bool begin);
 
     /**
-     * @brief Set the digits object
+     * @brief Merged counters of all threads.
      *
-     * @param n Vector of digits.
-     * @return Reference to the updated bigint.
      */
-    bigint &set_digits(std::vector<uint8_t> n);
+    struct totals
+    {
+        uint64_t calls[event_count] = {};            ///< Calls per event.
+        uint64_t sizes[event_count][buckets] = {};   ///< Operand size histogram per event.
+        uint64_t bytes_copied = 0;                   ///< Digit bytes copied by copies and `get_digits()`.
+        uint64_t bytes_allocated = 0;                ///< Digit bytes of new buffers: results of parsing, `+`, `-`, products, squares, divisions, shifts and bitwise operations, copies, `get_digits()` and copy-on-write blocks.
+
+        /**
+         * @brief Prints the non-zero counters and histograms.
+         *
+         * @param os The output stream.
+         */
+        void print(std::ostream &os) const;
+    };
+
     /**
-     * @brief Adds a digit to the end of the bigint.
+     * @brief Name of an event.
      *
-     * @param n Digit to add.
-     * @return Reference to the updated bigint.
+     * @param e The event.
+     * @return The name, e.g. "mul_karatsuba".
      */
-    bigint &push_back(const uint8_t n);
+    static const char *name(event e);
     /**
-     * @brief Removes the last digit of the bigint.
+     * @brief Counts one occurrence of an event on the calling thread.
      *
-     * @return Reference to the updated bigint.
+     * @param e The event.
+     * @param digits Operand size in digits, recorded in the histogram.
      */
-    bigint &pop_back();
+    static void record(event e, uint64_t digits);
     /**
-     * @brief Inserts a digit at the specified position.
+     * @brief Adds digit bytes to the copy and allocation counters of the calling thread.
      *
-     * @param ind Iterator to the position.
-     * @param num Digit to insert.
-     * @return Reference to the updated bigint.
+     * @param copied Bytes copied.
+     * @param allocated Bytes allocated.
      */
-    bigint &insert(std::vector<uint8_t>::iterator ind, const uint8_t num);
+    static void record_bytes(uint64_t copied, uint64_t allocated);
     /**
-     * @brief Erases a digit at the specified position.
+     * @brief Merges the counters of all threads, including finished ones.
      *
-     * @param ind Iterator to the position.
-     * @return Reference to the updated bigint.
+     * @return The totals.
      */
-    bigint &erase(const std::vector<uint8_t>::iterator ind);
+    static totals collect();
+    /**
+     * @brief Sets all counters of all threads to zero.
+     *
+     */
+    static void reset();
+    /**
+     * @brief Installs or removes the trace hook.
+     *
+     * @param callback The hook, or nullptr to disable tracing.
+     */
+    static void set_trace(trace_callback callback);
+    /**
+     * @brief The installed trace hook.
+     *
+     * @return The hook, or nullptr.
+     */
+    static trace_callback trace();
 
+private:
     /**
-     * @brief Set the is_negative object
+     * @brief Counters of one thread, readable from other threads.
      *
-     * @param neg True if the bigint is negative.
-     * @return Reference to the updated bigint.
      */
-    bigint &set_negative(bool neg);
+    struct counters
+    {
+        std::atomic<uint64_t> calls[event_count];
+        std::atomic<uint64_t> sizes[event_count][buckets];
+        std::atomic<uint64_t> bytes_copied;
+        std::atomic<uint64_t> bytes_allocated;
+
+        counters();
+        /**
+         * @brief Adds these counters to totals.
+         *
+         * @param out The totals.
+         */
+        void add_to(totals &out) const;
+        /**
+         * @brief Sets all counters to zero.
+         *
+         */
+        void clear();
+    };
 
     /**
-     * @brief Returns an iterator to the beginning of the digits.
+     * @brief Registration of the counters of one thread; folds them into the shared total on exit.
      *
-     * @return Iterator pointing to the first digit.
      */
-    std::vector<uint8_t>::iterator begin();
+    struct thread_handle
+    {
+        counters *local;
+
+        thread_handle();
+        ~thread_handle();
+    };
+
     /**
-     * @brief Returns an iterator to the end of the digits.
+     * @brief Counters of all running threads and totals of finished ones.
      *
-     * @return Iterator pointing to one past the last digit.
      */
-    std::vector<uint8_t>::iterator end();
+    struct registry
+    {
+        std::mutex lock;
+        std::vector<counters *> live;
+        totals retired;
+        std::atomic<trace_callback> callback{nullptr};
+    };
 
     /**
-     * @brief Returns the number of digits in the bigint.
+     * @brief The process-wide registry.
      *
-     * @return The number of digits.
+     * @return Reference to the registry.
      */
-    size_t size() const;
+    static registry &shared();
     /**
-     * @brief Checks whether the bigint is zero.
+     * @brief The counters of the calling thread, registered on first use.
+     *
+     * @return Reference to the counters.
+     */
+    static counters &local();
+};
+
+/**
+ * @brief Scope guard that counts an event and reports its begin and end to the trace hook.
+ *
+ * Does nothing during constant evaluation.
+ */
+class bigint_span
+{
+private:
+    const char *operation; ///< Name passed to the trace hook, or nullptr if not traced.
+    uint64_t digits;       ///< Operand size passed to the trace hook.
+
+    /**
+     * @brief Counts the event and reports the begin of the span if a trace hook is installed.
+     *
+     * @param e The event.
+     */
+    void begin(bigint_instrument::event e);
+    /**
+     * @brief Reports the end of the span if a trace hook is still installed.
      *
-     * @return True if the bigint represents the value 0, false otherwise.
      */
-    bool is_zero() const;
+    void end();
 
 public:
     /**
-     * @brief Default constructor. Initializes the bigint to 0.
+     * @brief Counts the event and reports its begin.
      *
+     * @param e The event.
+     * @param digits Operand size in digits.
      */
-    bigint();
+    BIGINT_CONSTEXPR bigint_span(bigint_instrument::event e, uint64_t digits) : operation(nullptr), digits(digits)
+    {
+        if (!BIGINT_IS_CONSTANT_EVALUATED())
+            begin(e);
+    }
     /**
-     * @brief Constructor from a signed 64-bit integer.
+     * @brief Reports the end of the span.
      *
-     * @param n The integer to initialize with.
      */
-    bigint(int64_t n);
+    BIGINT_CONSTEXPR ~bigint_span()
+    {
+        if (operation)
+            end();
+    }
+    bigint_span(const bigint_span &) = delete;
+    bigint_span &operator=(const bigint_span &) = delete;
+};
+#endif
+
+/**
+ * @brief Instrumentation hooks; they expand to nothing unless `BIGINT_INSTRUMENT` is defined.
+ *
+ * `BIGINT_RECORD(event, digits)` counts one event, `BIGINT_RECORD_BYTES(copied, allocated)`
+ * adds digit bytes, and `BIGINT_SPAN(event, digits)` counts an event and traces the rest of the
+ * enclosing scope. All of them are skipped during constant evaluation.
+ */
+#ifdef BIGINT_INSTRUMENT
+#define BIGINT_RECORD(event, digits)                                        \
+    do                                                                      \
+    {                                                                       \
+        if (!BIGINT_IS_CONSTANT_EVALUATED())                                \
+            bigint_instrument::record(bigint_instrument::event, (digits)); \
+    } while (0)
+#define BIGINT_RECORD_BYTES(copied, allocated)                         \
+    do                                                                 \
+    {                                                                  \
+        if (!BIGINT_IS_CONSTANT_EVALUATED())                           \
+            bigint_instrument::record_bytes((copied), (allocated));   \
+    } while (0)
+#define BIGINT_SPAN(event, digits) bigint_span bigint_span_guard(bigint_instrument::event, (digits))
+#else
+#define BIGINT_RECORD(event, digits) ((void)0)
+#define BIGINT_RECORD_BYTES(copied, allocated) ((void)0)
+#define BIGINT_SPAN(event, digits) ((void)0)
+#endif
+
+/**
+ * @brief Counts the digit bytes copied into a new buffer by a bigint copy.
+ *
+ * Copy-on-write storage shares the digits instead and counts its own copies when it detaches.
+ */
+#ifdef BIGINT_SHARED_STORAGE
+#define BIGINT_DIGITS_COPIED(bytes) ((void)0)
+#else
+#define BIGINT_DIGITS_COPIED(bytes) BIGINT_RECORD_BYTES((bytes), (bytes))
+#endif
+
+class modular_context;
+
+#ifdef BIGINT_SHARED_STORAGE
+/**
+ * @brief Copy-on-write digit buffer with an atomic reference count.
+ *
+ * Copies share one immutable block and only bump its reference count. The first mutating access
+ * through a shared handle copies the block, so a value can be handed to other threads, containers
+ * and caches without duplicating its digits. Read access never copies. The interface is the
+ * subset of `std::vector<uint8_t>` used by bigint, and iterators are those of the vector inside
+ * the block.
+ */
+class bigint_storage
+{
+private:
+    /**
+     * @brief Reference-counted digit block.
+     */
+    struct block
+    {
+        std::atomic<size_t> references; ///< Number of handles sharing the block.
+        std::vector<uint8_t> data;      ///< The digits.
+
+        /**
+         * @brief Creates a block owned by a single handle.
+         *
+         * @param digits The digits to hold.
+         */
+        explicit block(std::vector<uint8_t> digits);
+    };
+
+    block *shared; ///< The block, or null for no digits.
+
     /**
-     * @brief Constructor from a string of digits.
+     * @brief Drops this handle's reference, freeing the block with the last one.
+     */
+    void release();
+    /**
+     * @brief The digits for reading.
      *
-     * @param n The string representation of the number.
-     * @throws std::invalid_argument if the string is contains non-number characters.
+     * @return The vector in the block, or an empty vector without a block.
      */
-    bigint(std::string n);
+    const std::vector<uint8_t> &data() const;
     /**
-     * @brief Copy constructor.
+     * @brief The digits for writing, copying the block first if it is shared.
      *
-     * @param other The bigint to copy.
+     * @return The vector in a block owned by this handle alone.
+     */
+    std::vector<uint8_t> &mutable_data();
+
+public:
+    typedef std::vector<uint8_t>::iterator iterator;                             ///< Mutable iterator.
+    typedef std::vector<uint8_t>::const_iterator const_iterator;                 ///< Read-only iterator.
+    typedef std::vector<uint8_t>::const_reverse_iterator const_reverse_iterator; ///< Read-only reverse iterator.
+
+    /**
+     * @brief Creates an empty buffer without allocating.
      */
-    bigint(const bigint &other);
+    bigint_storage();
     /**
-     * @brief Destroy the bigint object
+     * @brief Creates a buffer holding a copy of digits.
      *
+     * @param digits The digits.
      */
-    ~bigint() = default;
+    bigint_storage(const std::vector<uint8_t> &digits);
+    /**
+     * @brief Shares the block of another buffer.
+     *
+     * @param other The buffer to share.
+     */
+    bigint_storage(const bigint_storage &other);
+    /**
+     * @brief Takes over the block of another buffer, leaving it empty.
+     *
+     * @param other The buffer to take over.
+     */
+    bigint_storage(bigint_storage &&other) noexcept;
+    /**
+     * @brief Shares the block of another buffer.
+     *
+     * @param other The buffer to share.
+     * @return Reference to this buffer.
+     */
+    bigint_storage &operator=(const bigint_storage &other);
+    /**
+     * @brief Takes over the block of another buffer.
+     *
+     * @param other The buffer to take over.
+     * @return Reference to this buffer.
+     */
+    bigint_storage &operator=(bigint_storage &&other) noexcept;
+    /**
+     * @brief Replaces the digits with a copy of a vector.
+     *
+     * @param digits The new digits.
+     * @return Reference to this buffer.
+     */
+    bigint_storage &operator=(const std::vector<uint8_t> &digits);
+    /**
+     * @brief Drops the reference to the block.
+     */
+    ~bigint_storage();
 
     /**
-     * @brief Get the is_negative object
+     * @brief Copies the digits out.
      *
-     * @return True if the bigint is negative, false otherwise.
+     * @return The digits as a vector.
      */
-    bool get_is_negative() const;
+    operator std::vector<uint8_t>() const;
     /**
-     * @brief Get the digits object
+     * @brief Compares digits, without reading them when both handles share a block.
      *
-     * @return A vector containing the digits of the bigint.
+     * @param other The buffer to compare.
+     * @return True if the digit sequences are equal.
+     */
+    bool operator==(const bigint_storage &other) const;
+    /**
+     * @brief Checks whether the block is shared with another handle.
+     *
+     * @return True if at least one other handle references the block.
      */
-    std::vector<uint8_t> get_digits() const;
+    bool is_shared() const;
 
     /**
-     * @brief Adds two bigints.
+     * @brief Number of digits.
      *
-     * @param other The other bigint to add.
-     * @return The sum of the two bigints.
+     * @return The number of digits.
      */
-    bigint operator+(bigint const &other) const;
+    size_t size() const;
     /**
-     * @brief Adds another bigint to this bigint.
+     * @brief Checks whether there are no digits.
      *
-     * @param increment The bigint to add.
-     * @return Reference to the updated bigint.
+     * @return True if the buffer is empty.
      */
-    bigint &operator+=(bigint const &increment);
+    bool empty() const;
     /**
-     * @brief Pre-increment operator.
+     * @brief Reads a digit.
      *
-     * @return Reference to the updated bigint.
+     * @param i Index of the digit.
+     * @return The digit at index `i`.
      */
-    bigint &operator++();
+    uint8_t operator[](size_t i) const;
     /**
-     * @brief Post-increment operator.
+     * @brief Accesses a digit for writing, unsharing the block first.
      *
-     * @return The value of the bigint before incrementing.
+     * @param i Index of the digit.
+     * @return Reference to the digit at index `i`.
      */
-    bigint operator++(int);
-
+    uint8_t &operator[](size_t i);
     /**
-     * @brief Subtracts one bigint from another.
+     * @brief Reads the last digit.
      *
-     * @param other The bigint to subtract.
-     * @return The difference of the two bigints.
+     * @return The last digit.
      */
-    bigint operator-(bigint const &other) const;
+    uint8_t back() const;
     /**
-     * @brief Subtracts another bigint from this bigint.
+     * @brief Accesses the last digit for writing, unsharing the block first.
      *
-     * @param decrement The bigint to subtract.
-     * @return Reference to the updated bigint.
+     * @return Reference to the last digit.
      */
-    bigint &operator-=(bigint const &decrement);
+    uint8_t &back();
     /**
-     * @brief Pre-decrement operator.
+     * @brief Read-only iterator to the first digit.
      *
-     * @return Reference to the updated bigint.
+     * @return Iterator pointing to the first digit.
      */
-    bigint &operator--();
+    const_iterator begin() const;
     /**
-     * @brief Post-decrement operator.
+     * @brief Read-only iterator past the last digit.
      *
-     * @return The value of the bigint before decrementing.
+     * @return Iterator pointing to one past the last digit.
      */
-    bigint operator--(int);
-
+    const_iterator end() const;
     /**
-     * @brief Multiplies two bigints.
+     * @brief Mutable iterator to the first digit, unsharing the block first.
      *
-     * @param other other The bigint to multiply.
-     * @return The product of the two bigints.
+     * @return Iterator pointing to the first digit.
      */
-    bigint operator*(bigint const &other) const;
+    iterator begin();
     /**
-     * @brief Multiplies another bigint with this bigint.
+     * @brief Mutable iterator past the last digit, unsharing the block first.
      *
-     * @param multiplier The bigint to multiply.
-     * @return Reference to the updated bigint.
+     * @return Iterator pointing to one past the last digit.
      */
-    bigint &operator*=(bigint const &multiplier);
-
+    iterator end();
     /**
-     * @brief Flips the sign of the bigint.
+     * @brief Reverse iterator to the last digit.
      *
-     * @return A new bigint that is the negation of the current bigint.
+     * @return Iterator pointing to the last digit.
      */
-    bigint operator-() const;
+    const_reverse_iterator rbegin() const;
     /**
-     * @brief The absolute value of a bigint
+     * @brief Reverse iterator before the first digit.
      *
-     * @return A new bigint that is the absolute value of the current bigint.
+     * @return Iterator pointing to one before the first digit.
      */
-    bigint abs() const;
-
+    const_reverse_iterator rend() const;
     /**
-     * @brief Compares two bigints for equality.
+     * @brief Appends a digit.
      *
-     * @param other The bigint to compare.
-     * @return True if the two bigints are equal, false otherwise.
+     * @param digit The digit to append.
      */
-    bool operator==(bigint const &other) const;
+    void push_back(uint8_t digit);
     /**
-     * @brief Compares two bigints for inequality.
+     * @brief Removes the last digit.
      *
-     * @param other The bigint to compare.
-     * @return True if the two bigints are not equal, false otherwise.
      */
-    bool operator!=(bigint const &other) const;
+    void pop_back();
     /**
-     * @brief Compares if this bigint is less than another bigint.
+     * @brief Removes every digit, dropping the block if it is shared.
      *
-     * @param other The bigint to compare.
-     * @return True if this bigint is less than the other, false otherwise.
      */
-    bool operator<(bigint const &other) const;
+    void clear();
     /**
-     * @brief Compares if this bigint is greater than another bigint.
+     * @brief Reserves room for digits.
      *
-     * @param other The bigint to compare.
-     * @return True if this bigint is greater than the other, false otherwise.
+     * @param capacity Number of digits to reserve.
      */
-    bool operator>(bigint const &other) const;
+    void reserve(size_t capacity);
     /**
-     * @brief Compares if this bigint is less than or equal to another bigint.
+     * @brief Changes the number of digits, padding with zeros.
      *
-     * @param other The bigint to compare.
-     * @return True if this bigint is less than or equal to the other, false otherwise.
+     * @param count The new number of digits.
      */
-    bool operator<=(bigint const &other) const;
+    void resize(size_t count);
     /**
-     * @brief Compares if this bigint is greater than or equal to another bigint.
+     * @brief Inserts a digit.
      *
-     * @param other The bigint to compare.
-     * @return True if this bigint is greater than or equal to the other, false otherwise.
+     * @param position Where to insert; must come from this buffer.
+     * @param digit The digit to insert.
+     * @return Iterator to the inserted digit.
      */
-    bool operator>=(bigint const &other) const;
-
+    iterator insert(iterator position, uint8_t digit);
     /**
-     * @brief Assigns one bigint to another.
+     * @brief Inserts copies of a digit.
      *
-     * @param other The bigint to assign from.
-     * @return Reference to the updated bigint.
+     * @param position Where to insert; must come from this buffer.
+     * @param count Number of copies.
+     * @param digit The digit to insert.
+     * @return Iterator to the first inserted digit.
      */
-    bigint &operator=(const bigint &other);
-
+    iterator insert(iterator position, size_t count, uint8_t digit);
     /**
-     * @brief Outputs the bigint to a stream.
+     * @brief Erases a digit.
      *
-     * @param os The output stream.
-     * @param n The bigint to print.
-     * @return Reference to the output stream.
+     * @param position The digit to erase; must come from this buffer.
+     * @return Iterator following the erased digit.
      */
-    friend std::ostream &operator<<(std::ostream &os, const bigint &n);
-};
+    iterator erase(iterator position);
 
-bigint::bigint()
-{
-    push_back(uint8_t(0));
-    is_negative = false;
-}
-bigint::bigint(int64_t n)
-{
-    if (n < 0)
+    /**
+     * @brief Inserts a range of digits.
+     *
+     * @param position Where to insert; must come from this buffer.
+     * @param first Start of the range.
+     * @param last End of the range.
+     * @return Iterator to the first inserted digit.
+     */
+    template <typename It>
+    iterator insert(iterator position, It first, It last)
     {
-        is_negative = true;
-        n = -n;
+        return mutable_data().insert(position, first, last);
     }
-    else
+    /**
+     * @brief Replaces the digits with a range.
+     *
+     * @param first Start of the range.
+     * @param last End of the range.
+     */
+    template <typename It>
+    void assign(It first, It last)
     {
+        *this = std::vector<uint8_t>(first, last);
+    }
+};
+
+/**
+ * @brief Digit container of bigint: shared copy-on-write storage when `BIGINT_SHARED_STORAGE` is defined.
+ *
+ */
+typedef bigint_storage bigint_digits;
+#else
+/**
+ * @brief Digit container of bigint: a plain vector unless `BIGINT_SHARED_STORAGE` is defined.
+ *
+ */
+typedef std::vector<uint8_t> bigint_digits;
+#endif
+
+class bigint
+{
+private:
+    /**
+     * @brief
+     *
+     */
+    bigint_digits digits; ///< Digits of the number stored in reverse order (least significant digit first).
+    bool is_negative;     ///< Sign of the number (true for negative, false for non-negative).
+
+    /**
+     * @brief Gets a digit at a specific index.
+     *
+     * @param n Index of the digit.
+     * @return The digit at the specified index or 0 if out of bounds.
+     */
+    BIGINT_CONSTEXPR uint8_t get_digit(const uint64_t n) const;
+
+    /**
+     * @brief Set the digits object
+     *
+     * @param n Vector of digits.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &set_digits(std::vector<uint8_t> n);
+    /**
+     * @brief Adds a digit to the end of the bigint.
+     *
+     * @param n Digit to add.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &push_back(const uint8_t n);
+    /**
+     * @brief Removes the last digit of the bigint.
+     *
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &pop_back();
+    /**
+     * @brief Inserts a digit at the specified position.
+     *
+     * @param ind Iterator to the position.
+     * @param num Digit to insert.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &insert(std::vector<uint8_t>::iterator ind, const uint8_t num);
+    /**
+     * @brief Erases a digit at the specified position.
+     *
+     * @param ind Iterator to the position.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &erase(const std::vector<uint8_t>::iterator ind);
+
+    /**
+     * @brief Set the is_negative object
+     *
+     * @param neg True if the bigint is negative.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &set_negative(bool neg);
+
+    /**
+     * @brief Returns an iterator to the beginning of the digits.
+     *
+     * @return Iterator pointing to the first digit.
+     */
+    BIGINT_CONSTEXPR std::vector<uint8_t>::iterator begin();
+    /**
+     * @brief Returns an iterator to the end of the digits.
+     *
+     * @return Iterator pointing to one past the last digit.
+     */
+    BIGINT_CONSTEXPR std::vector<uint8_t>::iterator end();
+
+    /**
+     * @brief Returns the number of digits in the bigint.
+     *
+     * @return The number of digits.
+     */
+    BIGINT_CONSTEXPR size_t size() const;
+    /**
+     * @brief Checks whether the bigint is zero.
+     *
+     * @return True if the bigint represents the value 0, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool is_zero() const;
+    /**
+     * @brief Extracts a run of digits as a non-negative bigint.
+     *
+     * @param shift Number of least significant digits to skip.
+     * @param count Number of digits to keep.
+     * @return The value `(|*this| / 10^shift) % 10^count`.
+     */
+    BIGINT_CONSTEXPR bigint slice(size_t shift, size_t count) const;
+    /**
+     * @brief Multiplies two bigints, choosing schoolbook or Karatsuba by operand size.
+     *
+     * Below `BIGINT_MUL_KARATSUBA_THRESHOLD` digits the product is summed in `bigint_columns`.
+     * Balanced operands are split in halves and multiplied with three half-size products; a much
+     * longer operand is cut into pieces as long as the shorter one, so every product is balanced.
+     *
+     * @param a The first factor.
+     * @param b The second factor.
+     * @return The product `a * b`.
+     */
+    static BIGINT_CONSTEXPR bigint multiply(const bigint &a, const bigint &b);
+    /**
+     * @brief Adds a bigint to this one in place, reusing this bigint's digit buffer.
+     *
+     * Only the digits that `term` reaches and the carry or borrow beyond them are touched, and the
+     * buffer is only grown when the result is longer than it.
+     *
+     * @param term The bigint to add.
+     * @param negate True to subtract `term` instead.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &add_in_place(const bigint &term, bool negate);
+    /**
+     * @brief Runs the hash over the sign and digits.
+     *
+     * The first lane is the 64-bit hash; the second lane, with its own constants, is only run
+     * when `wide` is set.
+     *
+     * @param seed Seed of the hash.
+     * @param wide Whether to compute the second lane.
+     * @return The finalised first and second lanes.
+     */
+    BIGINT_CONSTEXPR std::pair<uint64_t, uint64_t> hash_lanes(uint64_t seed, bool wide) const;
+    /**
+     * @brief Value of the leading significant digits.
+     *
+     * @param count Number of digits to read, at most 19.
+     * @return The first `min(count, size())` significant digits as an integer.
+     */
+    BIGINT_CONSTEXPR uint64_t leading_digits(size_t count) const;
+    /**
+     * @brief Reads the absolute value into a machine word.
+     *
+     * @param magnitude Receives `|*this|` on success.
+     * @return False if `|*this|` needs more than 64 bits; at most 20 digits are read.
+     */
+    BIGINT_CONSTEXPR bool magnitude_word(uint64_t &magnitude) const;
+    /**
+     * @brief Correctly rounded conversion to a binary floating-point type.
+     *
+     * @tparam T `double` or `long double`.
+     * @return The value of `T` nearest to `*this`, ties to even, or an infinity past the range.
+     */
+    template <typename T>
+    T to_floating() const;
+    /**
+     * @brief Converts the absolute value to binary words.
+     *
+     * The digits are first grouped into base 10^9 chunks, which are then repeatedly divided by 2^32.
+     *
+     * @return The magnitude in base 2^32, least significant word first; empty for 0.
+     */
+    std::vector<uint32_t> to_words() const;
+    /**
+     * @brief Builds a bigint from binary words.
+     *
+     * The words are accumulated most significant first into base 10^9 chunks, which are then
+     * split into digits.
+     *
+     * @param words The magnitude in base 2^32, least significant word first.
+     * @param negative Sign of the result; ignored for 0.
+     * @return The bigint with the given magnitude and sign.
+     */
+    static bigint from_words(const std::vector<uint32_t> &words, bool negative);
+    /**
+     * @brief Applies a word operation to the infinite two's-complement forms of two bigints.
+     *
+     * Negative operands are converted to `~(|n| - 1)` and sign-extended with all-ones words; the
+     * sign of the result is the operation applied to the two sign extensions.
+     *
+     * @param a The first operand.
+     * @param b The second operand.
+     * @param op The operation on one word of each operand.
+     * @return The bigint whose two's-complement form is the result.
+     */
+    static bigint bitwise(const bigint &a, const bigint &b, uint32_t (*op)(uint32_t, uint32_t));
+    /**
+     * @brief Schoolbook long division of absolute values.
+     *
+     * Each quotient digit is estimated from the leading 18 digits of the running remainder and the
+     * divisor, then corrected by at most a couple of add-backs.
+     *
+     * @param a The dividend.
+     * @param b The divisor; must not be zero.
+     * @param quotient Receives `|a| / |b|`.
+     * @param remainder Receives `|a| % |b|`.
+     */
+    static BIGINT_CONSTEXPR void divmod_abs(const bigint &a, const bigint &b, bigint &quotient, bigint &remainder);
+    /**
+     * @brief Remainder of the absolute value by a machine word.
+     *
+     * @param m The modulus, in [1, 10^18].
+     * @return `|*this| % m`.
+     */
+    uint64_t mod_word(uint64_t m) const;
+    /**
+     * @brief Floor of the k-th root of a machine word.
+     *
+     * @param n The radicand.
+     * @param k The root index, at least 1.
+     * @return The largest `x` with `x^k <= n`.
+     */
+    static uint64_t root_word(uint64_t n, uint64_t k);
+    /**
+     * @brief Floor of the k-th root of an absolute value by Newton iteration.
+     *
+     * The root of the leading half of the digits is computed recursively and, rounded up and
+     * scaled, gives an overestimate accurate to about half the digits. Newton steps from above
+     * then double the precision each time and stop as soon as the iterate no longer decreases.
+     *
+     * @param n The radicand; its sign is ignored.
+     * @param k The root index, at least 1.
+     * @return The largest `x` with `x^k <= |n|`.
+     */
+    static bigint root_abs(const bigint &n, uint64_t k);
+    /**
+     * @brief The odd and even primes below 10000, computed once by a sieve of Eratosthenes.
+     *
+     * @return The primes in increasing order.
+     */
+    static const std::vector<uint32_t> &small_primes();
+    /**
+     * @brief Remainders of an absolute value by the first small primes.
+     *
+     * Primes are grouped so that their product stays below 10^17, and each group costs a single
+     * pass over the digits.
+     *
+     * @param n The bigint.
+     * @param count Number of primes from `small_primes()` to use.
+     * @return `|n| % p` for each of the first `count` primes.
+     */
+    static std::vector<uint32_t> small_residues(const bigint &n, size_t count);
+    /**
+     * @brief Strong probable prime test to one base (Miller-Rabin round).
+     *
+     * @param context Montgomery context of the odd candidate n.
+     * @param base The base, in [2, n - 2].
+     * @return False if `base` proves n composite.
+     */
+    static bool miller_rabin(const modular_context &context, const bigint &base);
+    /**
+     * @brief Strong Lucas probable prime test with Selfridge's parameters.
+     *
+     * D is the first of 5, -7, 9, -11, ... with Jacobi symbol (D / n) == -1, P = 1 and
+     * Q = (1 - D) / 4. U and V are built in Montgomery form with doubling and add-one steps.
+     *
+     * @param context Montgomery context of the odd candidate n, which must exceed 10^6.
+     * @return False if n is proven composite.
+     */
+    static bool strong_lucas(const modular_context &context);
+    /**
+     * @brief Product of a run of bigints as a balanced binary tree.
+     *
+     * Both halves are multiplied recursively, so factors of similar size always meet a factor of
+     * similar size. While more than one thread is available, the left half runs on a new thread.
+     *
+     * @param factors The factors.
+     * @param begin First factor of the run.
+     * @param end One past the last factor of the run.
+     * @param threads Number of threads for this subtree.
+     * @return The product of `factors[begin, end)`, 1 for an empty run.
+     */
+    static bigint product_tree(const std::vector<bigint> &factors, size_t begin, size_t end, size_t threads);
+    /**
+     * @brief Product of machine words.
+     *
+     * Consecutive words are first multiplied together while the product fits in 64 bits, and the
+     * packed words are then multiplied with `product_tree`.
+     *
+     * @param words The factors, all non-zero.
+     * @param threads Number of threads.
+     * @return The product of the words, 1 for an empty list.
+     */
+    static bigint product_words(const std::vector<uint64_t> &words, size_t threads);
+    /**
+     * @brief Product of prime powers `p^e` by squaring.
+     *
+     * The result is built from the highest exponent bit down: it is squared once per bit and
+     * multiplied by the product of the primes whose exponent has that bit set. Most of the work
+     * is then done by `square()` and balanced products. With several threads, the square and
+     * the product of the primes run concurrently, and the square is multiplied in pieces.
+     *
+     * @param primes The primes.
+     * @param exponents The exponent of each prime.
+     * @param threads Number of threads.
+     * @return The product of `primes[i]^exponents[i]`.
+     */
+    static bigint prime_power_product(const std::vector<uint64_t> &primes, const std::vector<uint64_t> &exponents, size_t threads);
+    /**
+     * @brief The primes up to a bound, by a sieve of Eratosthenes over the odd numbers.
+     *
+     * @param n The bound.
+     * @return The primes `p <= n` in increasing order.
+     */
+    static std::vector<uint64_t> primes_up_to(uint64_t n);
+
+public:
+    /**
+     * @brief Default constructor. Initializes the bigint to 0.
+     *
+     */
+    BIGINT_CONSTEXPR bigint();
+    /**
+     * @brief Constructor from a signed 64-bit integer.
+     *
+     * @param n The integer to initialize with.
+     */
+    BIGINT_CONSTEXPR bigint(int64_t n);
+    /**
+     * @brief Constructor from a string of digits.
+     *
+     * @param n The string representation of the number.
+     * @throws std::invalid_argument if the string is contains non-number characters.
+     */
+    BIGINT_CONSTEXPR bigint(std::string n);
+    /**
+     * @brief Copy constructor.
+     *
+     * @param other The bigint to copy.
+     */
+    BIGINT_CONSTEXPR bigint(const bigint &other);
+    /**
+     * @brief Move constructor. Leaves `other` as 0 with no digits, which reads as 0 and needs no allocation.
+     *
+     * @param other The bigint to move from.
+     */
+    BIGINT_CONSTEXPR bigint(bigint &&other) noexcept;
+    /**
+     * @brief Destroy the bigint object
+     *
+     */
+    ~bigint() = default;
+
+    /**
+     * @brief Get the is_negative object
+     *
+     * @return True if the bigint is negative, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool get_is_negative() const;
+    /**
+     * @brief Get the digits object
+     *
+     * @return A vector containing the digits of the bigint.
+     */
+    BIGINT_CONSTEXPR std::vector<uint8_t> get_digits() const;
+
+    /**
+     * @brief Converts to the nearest `double`.
+     *
+     * Values of up to 19 digits are converted from one machine word. Longer values are rounded from
+     * their exact binary form, ties to even; values of more than 309 digits are past the range.
+     *
+     * @return The nearest `double`, or an infinity with the sign of the bigint if it is out of range.
+     */
+    double to_double() const;
+    /**
+     * @brief Converts to the nearest `long double`.
+     *
+     * @return The nearest `long double`, or an infinity with the sign of the bigint if it is out of range.
+     */
+    long double to_long_double() const;
+    /**
+     * @brief Creates a bigint from the integer part of a `double`.
+     *
+     * @param x The value, truncated toward zero.
+     * @return The exact integer part of `x`.
+     * @throws std::invalid_argument if `x` is an infinity or NaN.
+     */
+    static bigint from_double(double x);
+    /**
+     * @brief Checks whether the bigint fits in an `int64_t`.
+     *
+     * @return True if `to_int64()` does not throw. At most 20 digits are read.
+     */
+    BIGINT_CONSTEXPR bool fits_int64() const;
+    /**
+     * @brief Converts to an `int64_t`.
+     *
+     * @return The value.
+     * @throws std::invalid_argument if the value is outside the range of `int64_t`.
+     */
+    BIGINT_CONSTEXPR int64_t to_int64() const;
+    /**
+     * @brief Converts to a `uint64_t`.
+     *
+     * @return The value.
+     * @throws std::invalid_argument if the value is negative or needs more than 64 bits.
+     */
+    BIGINT_CONSTEXPR uint64_t to_uint64() const;
+    /**
+     * @brief Number of decimal digits of the absolute value.
+     *
+     * @return The length of the printed absolute value, 1 for 0.
+     */
+    BIGINT_CONSTEXPR uint64_t decimal_digit_count() const;
+    /**
+     * @brief Approximate base-2 logarithm of the absolute value.
+     *
+     * Only the 19 leading digits and the digit count are read; the relative error is about `10^-18`.
+     *
+     * @return `log2(|*this|)`, or minus infinity for 0.
+     */
+    double log2() const;
+    /**
+     * @brief Approximate base-10 logarithm of the absolute value.
+     *
+     * @return `log10(|*this|)`, or minus infinity for 0.
+     */
+    double log10() const;
+
+    /**
+     * @brief Adds two bigints.
+     *
+     * @param other The other bigint to add.
+     * @return The sum of the two bigints.
+     */
+    BIGINT_CONSTEXPR bigint operator+(bigint const &other) const;
+    /**
+     * @brief Adds another bigint to this bigint.
+     *
+     * @param increment The bigint to add.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &operator+=(bigint const &increment);
+    /**
+     * @brief Pre-increment operator.
+     *
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &operator++();
+    /**
+     * @brief Post-increment operator.
+     *
+     * @return The value of the bigint before incrementing.
+     */
+    BIGINT_CONSTEXPR bigint operator++(int);
+
+    /**
+     * @brief Subtracts one bigint from another.
+     *
+     * @param other The bigint to subtract.
+     * @return The difference of the two bigints.
+     */
+    BIGINT_CONSTEXPR bigint operator-(bigint const &other) const;
+    /**
+     * @brief Subtracts another bigint from this bigint.
+     *
+     * @param decrement The bigint to subtract.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &operator-=(bigint const &decrement);
+    /**
+     * @brief Pre-decrement operator.
+     *
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &operator--();
+    /**
+     * @brief Post-decrement operator.
+     *
+     * @return The value of the bigint before decrementing.
+     */
+    BIGINT_CONSTEXPR bigint operator--(int);
+
+    /**
+     * @brief Multiplies two bigints.
+     *
+     * @param other other The bigint to multiply.
+     * @return The product of the two bigints.
+     */
+    BIGINT_CONSTEXPR bigint operator*(bigint const &other) const;
+    /**
+     * @brief Multiplies another bigint with this bigint.
+     *
+     * @param multiplier The bigint to multiply.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &operator*=(bigint const &multiplier);
+    /**
+     * @brief Adds the product of two bigints to this bigint, `*this += x * y`.
+     *
+     * The product is added into the digits of this bigint in place, so unlike `*this += x * y` no
+     * sum of the accumulator's length is allocated and copied.
+     *
+     * @param x The first factor.
+     * @param y The second factor.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &addmul(bigint const &x, bigint const &y);
+    /**
+     * @brief Subtracts the product of two bigints from this bigint, `*this -= x * y`, in place.
+     *
+     * @param x The first factor.
+     * @param y The second factor.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &submul(bigint const &x, bigint const &y);
+
+    /**
+     * @brief Flips the sign of the bigint.
+     *
+     * @return A new bigint that is the negation of the current bigint.
+     */
+    BIGINT_CONSTEXPR bigint operator-() const;
+    /**
+     * @brief The absolute value of a bigint
+     *
+     * @return A new bigint that is the absolute value of the current bigint.
+     */
+    BIGINT_CONSTEXPR bigint abs() const;
+    /**
+     * @brief Squares the bigint with the dedicated squaring kernel.
+     *
+     * Operands shorter than `BIGINT_SQR_KARATSUBA_THRESHOLD` digits use schoolbook squaring with
+     * doubled cross products; longer operands are split in halves and squared recursively with
+     * Karatsuba's three half-size squares.
+     *
+     * @return The square of the bigint.
+     */
+    BIGINT_CONSTEXPR bigint square() const;
+
+    /**
+     * @brief Shifts the bigint left, i.e. multiplies it by 2^shift.
+     *
+     * The magnitude is converted to binary words once, moved by whole words and funnel-shifted
+     * by the remaining bits in a single pass.
+     *
+     * @param shift Number of bits.
+     * @return `*this * 2^shift`.
+     */
+    bigint operator<<(uint64_t shift) const;
+    /**
+     * @brief Shifts the bigint left in place.
+     *
+     * @param shift Number of bits.
+     * @return Reference to the updated bigint.
+     */
+    bigint &operator<<=(uint64_t shift);
+    /**
+     * @brief Arithmetic right shift, i.e. division by 2^shift rounded toward negative infinity.
+     *
+     * @param shift Number of bits.
+     * @return `floor(*this / 2^shift)`, so `-1 >> shift == -1`.
+     */
+    bigint operator>>(uint64_t shift) const;
+    /**
+     * @brief Arithmetic right shift in place.
+     *
+     * @param shift Number of bits.
+     * @return Reference to the updated bigint.
+     */
+    bigint &operator>>=(uint64_t shift);
+    /**
+     * @brief Bitwise AND of the infinite two's-complement forms.
+     *
+     * @param other The other operand.
+     * @return The bitwise AND.
+     */
+    bigint operator&(bigint const &other) const;
+    /**
+     * @brief Bitwise AND in place.
+     *
+     * @param other The other operand.
+     * @return Reference to the updated bigint.
+     */
+    bigint &operator&=(bigint const &other);
+    /**
+     * @brief Bitwise OR of the infinite two's-complement forms.
+     *
+     * @param other The other operand.
+     * @return The bitwise OR.
+     */
+    bigint operator|(bigint const &other) const;
+    /**
+     * @brief Bitwise OR in place.
+     *
+     * @param other The other operand.
+     * @return Reference to the updated bigint.
+     */
+    bigint &operator|=(bigint const &other);
+    /**
+     * @brief Bitwise XOR of the infinite two's-complement forms.
+     *
+     * @param other The other operand.
+     * @return The bitwise XOR.
+     */
+    bigint operator^(bigint const &other) const;
+    /**
+     * @brief Bitwise XOR in place.
+     *
+     * @param other The other operand.
+     * @return Reference to the updated bigint.
+     */
+    bigint &operator^=(bigint const &other);
+    /**
+     * @brief Bitwise NOT of the infinite two's-complement form.
+     *
+     * @return `-*this - 1`.
+     */
+    BIGINT_CONSTEXPR bigint operator~() const;
+    /**
+     * @brief Number of bits of the absolute value.
+     *
+     * Found in constant time from the 19 leading digits and the digit count, except when a power of
+     * two lies within the range those digits allow. That happens for about one value in `10^18`
+     * and for every power of two and its neighbours; the power is then built with `pow` and compared
+     * digit by digit, which costs as much as `pow(bigint(2), k)`.
+     *
+     * @return The smallest `k` with `|*this| < 2^k`; 0 for 0.
+     */
+    uint64_t bit_length() const;
+    /**
+     * @brief Number of one bits of the absolute value.
+     *
+     * @return The population count of `|*this|`.
+     */
+    uint64_t popcount() const;
+    /**
+     * @brief Reads one bit of the infinite two's-complement form.
+     *
+     * @param n The bit index, 0 for the least significant bit.
+     * @return The bit `n`, which is set for every large `n` when the bigint is negative.
+     */
+    bool test_bit(uint64_t n) const;
+    /**
+     * @brief Sets or clears one bit of the infinite two's-complement form.
+     *
+     * @param n The bit index, 0 for the least significant bit.
+     * @param value The new value of the bit.
+     * @return Reference to the updated bigint.
+     */
+    bigint &set_bit(uint64_t n, bool value = true);
+
+    /**
+     * @brief Compares two bigints for equality.
+     *
+     * @param other The bigint to compare.
+     * @return True if the two bigints are equal, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool operator==(bigint const &other) const;
+    /**
+     * @brief Compares two bigints for inequality.
+     *
+     * @param other The bigint to compare.
+     * @return True if the two bigints are not equal, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool operator!=(bigint const &other) const;
+    /**
+     * @brief Compares if this bigint is less than another bigint.
+     *
+     * @param other The bigint to compare.
+     * @return True if this bigint is less than the other, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool operator<(bigint const &other) const;
+    /**
+     * @brief Compares if this bigint is greater than another bigint.
+     *
+     * @param other The bigint to compare.
+     * @return True if this bigint is greater than the other, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool operator>(bigint const &other) const;
+    /**
+     * @brief Compares if this bigint is less than or equal to another bigint.
+     *
+     * @param other The bigint to compare.
+     * @return True if this bigint is less than or equal to the other, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool operator<=(bigint const &other) const;
+    /**
+     * @brief Compares if this bigint is greater than or equal to another bigint.
+     *
+     * @param other The bigint to compare.
+     * @return True if this bigint is greater than or equal to the other, false otherwise.
+     */
+    BIGINT_CONSTEXPR bool operator>=(bigint const &other) const;
+
+    /**
+     * @brief Stable 64-bit hash of the value.
+     *
+     * The digits are packed sixteen to a word and mixed with XXH64-style rounds, so the result
+     * depends only on the value and the seed, not on the platform or storage mode.
+     *
+     * @param seed Seed of the hash.
+     * @return The hash.
+     */
+    BIGINT_CONSTEXPR uint64_t hash64(uint64_t seed = 0) const;
+    /**
+     * @brief Stable 128-bit hash of the value, for content-addressed keys and on-disk indexes.
+     *
+     * @param seed Seed of the hash.
+     * @return The low and high 64 bits of the hash.
+     */
+    BIGINT_CONSTEXPR std::pair<uint64_t, uint64_t> hash128(uint64_t seed = 0) const;
+
+    /**
+     * @brief Assigns one bigint to another.
+     *
+     * @param other The bigint to assign from.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &operator=(const bigint &other);
+    /**
+     * @brief Move assignment operator. Leaves `other` as 0 with no digits, which reads as 0 and needs no allocation.
+     *
+     * @param other The bigint to move from.
+     * @return Reference to the updated bigint.
+     */
+    BIGINT_CONSTEXPR bigint &operator=(bigint &&other) noexcept;
+
+    /**
+     * @brief Outputs the bigint to a stream.
+     *
+     * @param os The output stream.
+     * @param n The bigint to print.
+     * @return Reference to the output stream.
+     */
+    friend std::ostream &operator<<(std::ostream &os, const bigint &n);
+
+    friend class bigint_columns;
+    friend BIGINT_CONSTEXPR bigint pow(const bigint &base, uint64_t exponent);
+    friend class modular_context;
+    friend class bigint_divisor;
+    friend class bigint_batch;
+    friend class bigint_rns;
+    friend bigint iroot(const bigint &n, uint64_t k);
+    friend bool is_perfect_square(const bigint &n);
+    friend bool is_perfect_power(const bigint &n);
+    friend bool divisible_by(const bigint &a, const bigint &d);
+    friend bool divisible_by_2exp(const bigint &a, uint64_t k);
+    friend bool is_probable_prime(const bigint &n, uint64_t rounds);
+    friend bigint next_prime(const bigint &n);
+    friend bigint product(const std::vector<bigint> &factors, size_t threads);
+    friend bigint factorial(uint64_t n, size_t threads);
+    friend bigint binomial(uint64_t n, uint64_t k, size_t threads);
+    template <typename URBG>
+    friend bigint random_bits(uint64_t bits, URBG &urbg);
+    template <typename URBG>
+    friend bigint random_below(const bigint &bound, URBG &urbg);
+};
+
+/**
+ * @brief User-defined literal for bigints, e.g. `1000000007_big`.
+ *
+ * The literal is always read as decimal digits; digit separators (`'`) are skipped.
+ * In constant-evaluated contexts an invalid literal is a compile-time error.
+ *
+ * @param n The characters of the literal.
+ * @return The bigint represented by the literal.
+ * @throws std::invalid_argument if the literal contains non-decimal characters.
+ */
+BIGINT_CONSTEXPR bigint operator""_big(const char *n);
+
+/**
+ * @brief Hashes bigints directly from their digits, without converting them to strings.
+ *
+ */
+namespace std
+{
+    template <>
+    struct hash<bigint>
+    {
+        /**
+         * @brief Hashes a bigint.
+         *
+         * @param n The bigint.
+         * @return `n.hash64()`.
+         */
+        size_t operator()(const bigint &n) const noexcept
+        {
+            return static_cast<size_t>(n.hash64());
+        }
+    };
+}
+/**
+ * @brief Column-wise accumulator used to fuse several additions and products into a single carry pass.
+ *
+ * Every term is added digit by digit into signed 64-bit column sums (least significant column first)
+ * without propagating carries. `to_bigint()` propagates all carries at once, so a chain of `k` terms
+ * costs one pass per term plus a single normalisation instead of `k` full bigint additions.
+ * The accumulator tracks how much each column may have grown and propagates carries in place
+ * before any column sum could overflow, so arbitrarily many terms can be added.
+ */
+class bigint_columns
+{
+private:
+    std::vector<int64_t> columns; ///< Unnormalised column sums, least significant column first.
+    uint64_t load;                ///< Upper bound on the magnitude of any column sum.
+
+    /**
+     * @brief Makes room for a term that can change a column by up to `growth`.
+     *
+     * @param growth Largest possible change of a single column.
+     */
+    BIGINT_CONSTEXPR void reserve_load(uint64_t growth);
+
+    /**
+     * @brief Propagates carries so every column holds a digit in [0, 9].
+     *
+     * @param work Column sums to normalise in place; extended with the remaining carry.
+     * @return False if the value is negative, in which case the negative carry is left in the last column.
+     */
+    static BIGINT_CONSTEXPR bool propagate(std::vector<int64_t> &work);
+
+public:
+    /**
+     * @brief Number of digits stored for a bigint, used to size accumulators up front.
+     *
+     * @param n The bigint to measure.
+     * @return The length of the digit vector of `n`.
+     */
+    static BIGINT_CONSTEXPR size_t width(const bigint &n);
+
+    /**
+     * @brief Creates an empty accumulator with room for `width` columns.
+     *
+     * @param width Expected number of digits of the result.
+     */
+    BIGINT_CONSTEXPR explicit bigint_columns(size_t width = 0);
+
+    /**
+     * @brief Adds a bigint to the columns.
+     *
+     * @param n The bigint to add.
+     * @param negate True to subtract `n` instead.
+     * @param shift Number of columns to shift `n` left by, i.e. adds `n * 10^shift`.
+     * @return Reference to the updated accumulator.
+     */
+    BIGINT_CONSTEXPR bigint_columns &add(const bigint &n, bool negate = false, size_t shift = 0);
+    /**
+     * @brief Adds a signed 64-bit integer to the columns without building a bigint.
+     *
+     * @param n The integer to add.
+     * @return Reference to the updated accumulator.
+     */
+    BIGINT_CONSTEXPR bigint_columns &add(int64_t n);
+    /**
+     * @brief Adds the columns of another accumulator.
+     *
+     * @param other The accumulator to merge in.
+     * @return Reference to the updated accumulator.
+     */
+    BIGINT_CONSTEXPR bigint_columns &add(const bigint_columns &other);
+    /**
+     * @brief Adds the product of two bigints to the columns.
+     *
+     * Products whose shorter factor has fewer than `BIGINT_MUL_KARATSUBA_THRESHOLD` digits are
+     * multiplied digit by digit straight into the columns. Larger products are computed by
+     * `bigint::multiply`, so they use Karatsuba multiplication, and only their digits are added.
+     *
+     * @param a The first factor.
+     * @param b The second factor.
+     * @param negate True to subtract the product instead.
+     * @return Reference to the updated accumulator.
+     */
+    BIGINT_CONSTEXPR bigint_columns &add_product(const bigint &a, const bigint &b, bool negate = false);
+    /**
+     * @brief Adds the square of a bigint to the columns.
+     *
+     * Each cross product `a_i * a_j` with `i < j` is computed once and doubled, so this needs
+     * about half the digit multiplications of `add_product(a, a)`.
+     *
+     * @param a The bigint to square.
+     * @param negate True to subtract the square instead.
+     * @return Reference to the updated accumulator.
+     */
+    BIGINT_CONSTEXPR bigint_columns &add_square(const bigint &a, bool negate = false);
+
+    /**
+     * @brief Propagates all carries and returns the accumulated value.
+     *
+     * @return The sum of all terms added so far.
+     */
+    BIGINT_CONSTEXPR bigint to_bigint() const;
+};
+
+/**
+ * @brief Base of the lazy expression nodes returned by operators applied to `lazy(x)`.
+ *
+ * Nodes only hold references to their bigint leaves and are evaluated when converted to a bigint,
+ * so they must be assigned before the end of the full expression that created them.
+ *
+ * @tparam E The concrete node type.
+ */
+template <typename E>
+class bigint_expression
+{
+public:
+    /**
+     * @brief Returns the concrete node.
+     *
+     * @return Reference to the derived node.
+     */
+    const E &self() const
+    {
+        return static_cast<const E &>(*this);
+    }
+
+    /**
+     * @brief Evaluates the whole expression with a single carry pass.
+     *
+     * @return The value of the expression.
+     */
+    operator bigint() const
+    {
+        bigint_columns columns(self().width());
+        self().accumulate(columns, false);
+        return columns.to_bigint();
+    }
+};
+
+/**
+ * @brief Leaf node referring to an existing bigint.
+ *
+ */
+class bigint_ref : public bigint_expression<bigint_ref>
+{
+private:
+    const bigint &value; ///< The referenced bigint.
+
+public:
+    /**
+     * @brief Wraps a bigint as an expression leaf.
+     *
+     * @param n The bigint to refer to.
+     */
+    explicit bigint_ref(const bigint &n) : value(n) {}
+
+    /**
+     * @brief Returns the referenced bigint without copying it.
+     *
+     * @return Reference to the leaf value.
+     */
+    const bigint &operand() const
+    {
+        return value;
+    }
+    /**
+     * @brief Upper bound on the number of digits of the node.
+     *
+     * @return The digit count of the leaf.
+     */
+    size_t width() const
+    {
+        return bigint_columns::width(value);
+    }
+    /**
+     * @brief Adds the leaf to the columns.
+     *
+     * @param columns The accumulator.
+     * @param negate True to subtract the leaf.
+     */
+    void accumulate(bigint_columns &columns, bool negate) const
+    {
+        columns.add(value, negate);
+    }
+};
+
+/**
+ * @brief Node for the sum or difference of two expressions.
+ *
+ * @tparam L The left operand node.
+ * @tparam R The right operand node.
+ */
+template <typename L, typename R>
+class bigint_sum : public bigint_expression<bigint_sum<L, R>>
+{
+private:
+    L left;        ///< Left operand.
+    R right;       ///< Right operand.
+    bool subtract; ///< True if the right operand is subtracted.
+
+public:
+    /**
+     * @brief Builds the node `l + r` or `l - r`.
+     *
+     * @param l The left operand.
+     * @param r The right operand.
+     * @param sub True for a difference.
+     */
+    bigint_sum(const L &l, const R &r, bool sub) : left(l), right(r), subtract(sub) {}
+
+    /**
+     * @brief Evaluates the node into a bigint, used when the node is a factor of a product.
+     *
+     * @return The value of the node.
+     */
+    bigint operand() const
+    {
+        return *this;
+    }
+    /**
+     * @brief Upper bound on the number of digits of the node.
+     *
+     * @return One more digit than the wider operand.
+     */
+    size_t width() const
+    {
+        return std::max(left.width(), right.width()) + 1;
+    }
+    /**
+     * @brief Adds both operands to the columns without carrying.
+     *
+     * @param columns The accumulator.
+     * @param negate True to subtract the node.
+     */
+    void accumulate(bigint_columns &columns, bool negate) const
+    {
+        left.accumulate(columns, negate);
+        right.accumulate(columns, negate != subtract);
+    }
+};
+
+/**
+ * @brief Node for the product of two expressions.
+ *
+ * Leaves are multiplied straight into the destination columns; other operands are evaluated first.
+ *
+ * @tparam L The left operand node.
+ * @tparam R The right operand node.
+ */
+template <typename L, typename R>
+class bigint_product : public bigint_expression<bigint_product<L, R>>
+{
+private:
+    L left;  ///< Left factor.
+    R right; ///< Right factor.
+
+public:
+    /**
+     * @brief Builds the node `l * r`.
+     *
+     * @param l The left factor.
+     * @param r The right factor.
+     */
+    bigint_product(const L &l, const R &r) : left(l), right(r) {}
+
+    /**
+     * @brief Evaluates the node into a bigint.
+     *
+     * @return The value of the node.
+     */
+    bigint operand() const
+    {
+        return *this;
+    }
+    /**
+     * @brief Upper bound on the number of digits of the node.
+     *
+     * @return The sum of the operand widths.
+     */
+    size_t width() const
+    {
+        return left.width() + right.width();
+    }
+    /**
+     * @brief Adds the product to the columns with `bigint_columns::add_product`.
+     *
+     * Small products are multiplied straight into the columns. Products of factors with at least
+     * `BIGINT_MUL_KARATSUBA_THRESHOLD` digits are built by Karatsuba multiplication first and then
+     * added, so only the additive chain around them stays fused.
+     *
+     * @param columns The accumulator.
+     * @param negate True to subtract the product.
+     */
+    void accumulate(bigint_columns &columns, bool negate) const
+    {
+        columns.add_product(left.operand(), right.operand(), negate);
+    }
+};
+
+/**
+ * @brief Node for the negation of an expression.
+ *
+ * @tparam E The negated node.
+ */
+template <typename E>
+class bigint_negation : public bigint_expression<bigint_negation<E>>
+{
+private:
+    E inner; ///< The negated operand.
+
+public:
+    /**
+     * @brief Builds the node `-e`.
+     *
+     * @param e The operand to negate.
+     */
+    explicit bigint_negation(const E &e) : inner(e) {}
+
+    /**
+     * @brief Evaluates the node into a bigint.
+     *
+     * @return The value of the node.
+     */
+    bigint operand() const
+    {
+        return *this;
+    }
+    /**
+     * @brief Upper bound on the number of digits of the node.
+     *
+     * @return The width of the operand.
+     */
+    size_t width() const
+    {
+        return inner.width();
+    }
+    /**
+     * @brief Adds the operand to the columns with the opposite sign.
+     *
+     * @param columns The accumulator.
+     * @param negate True to add the operand itself.
+     */
+    void accumulate(bigint_columns &columns, bool negate) const
+    {
+        inner.accumulate(columns, !negate);
+    }
+};
+
+/**
+ * @brief Starts a lazily evaluated expression, e.g. `bigint r = lazy(a) + b - c;`.
+ *
+ * @param n The first operand.
+ * @return A leaf node referring to `n`.
+ */
+inline bigint_ref lazy(const bigint &n)
+{
+    return bigint_ref(n);
+}
+
+template <typename L, typename R>
+bigint_sum<L, R> operator+(const bigint_expression<L> &l, const bigint_expression<R> &r)
+{
+    return bigint_sum<L, R>(l.self(), r.self(), false);
+}
+template <typename L>
+bigint_sum<L, bigint_ref> operator+(const bigint_expression<L> &l, const bigint &r)
+{
+    return bigint_sum<L, bigint_ref>(l.self(), bigint_ref(r), false);
+}
+template <typename R>
+bigint_sum<bigint_ref, R> operator+(const bigint &l, const bigint_expression<R> &r)
+{
+    return bigint_sum<bigint_ref, R>(bigint_ref(l), r.self(), false);
+}
+
+template <typename L, typename R>
+bigint_sum<L, R> operator-(const bigint_expression<L> &l, const bigint_expression<R> &r)
+{
+    return bigint_sum<L, R>(l.self(), r.self(), true);
+}
+template <typename L>
+bigint_sum<L, bigint_ref> operator-(const bigint_expression<L> &l, const bigint &r)
+{
+    return bigint_sum<L, bigint_ref>(l.self(), bigint_ref(r), true);
+}
+template <typename R>
+bigint_sum<bigint_ref, R> operator-(const bigint &l, const bigint_expression<R> &r)
+{
+    return bigint_sum<bigint_ref, R>(bigint_ref(l), r.self(), true);
+}
+
+template <typename L, typename R>
+bigint_product<L, R> operator*(const bigint_expression<L> &l, const bigint_expression<R> &r)
+{
+    return bigint_product<L, R>(l.self(), r.self());
+}
+template <typename L>
+bigint_product<L, bigint_ref> operator*(const bigint_expression<L> &l, const bigint &r)
+{
+    return bigint_product<L, bigint_ref>(l.self(), bigint_ref(r));
+}
+template <typename R>
+bigint_product<bigint_ref, R> operator*(const bigint &l, const bigint_expression<R> &r)
+{
+    return bigint_product<bigint_ref, R>(bigint_ref(l), r.self());
+}
+
+template <typename E>
+bigint_negation<E> operator-(const bigint_expression<E> &e)
+{
+    return bigint_negation<E>(e.self());
+}
+
+/**
+ * @brief Fused multiply-add into an accumulator, `acc += x * y`.
+ *
+ * @param acc The accumulator.
+ * @param x The first factor.
+ * @param y The second factor.
+ * @return Reference to the updated accumulator.
+ */
+BIGINT_CONSTEXPR bigint &fma(bigint &acc, bigint const &x, bigint const &y);
+
+/**
+ * @brief Raises a bigint to a non-negative integer power.
+ *
+ * Uses left-to-right sliding-window exponentiation on top of `bigint::square()`, with the odd power
+ * table and the window products computed by Karatsuba-aware multiplication. Trailing zeros of
+ * the base are factored out first, so powers of 10 (and of any `d * 10^j`) only append zeros.
+ *
+ * @param base The base.
+ * @param exponent The exponent; `pow(x, 0)` is 1 for every x, including 0.
+ * @return `base` raised to `exponent`.
+ */
+BIGINT_CONSTEXPR bigint pow(const bigint &base, uint64_t exponent);
+
+/**
+ * @brief Sums a range of bigints with a single carry pass.
+ *
+ * @tparam Range Any range whose elements convert to bigint.
+ * @param range The terms to add.
+ * @return The sum of the terms, 0 for an empty range.
+ */
+template <typename Range>
+bigint sum(const Range &range)
+{
+    size_t width = 0;
+    for (const auto &term : range)
+    {
+        width = std::max(width, bigint_columns::width(term));
+    }
+    bigint_columns columns(width + 20);
+    for (const auto &term : range)
+    {
+        columns.add(term);
+    }
+    return columns.to_bigint();
+}
+
+/**
+ * @brief Dot product of two ranges of bigints with a single carry pass.
+ *
+ * @tparam RangeA Any range whose elements convert to bigint.
+ * @tparam RangeB Any range whose elements convert to bigint.
+ * @param range_a The first factors.
+ * @param range_b The second factors.
+ * @return The sum of `range_a[i] * range_b[i]`.
+ * @throws std::invalid_argument if the ranges have different lengths.
+ */
+template <typename RangeA, typename RangeB>
+bigint dot(const RangeA &range_a, const RangeB &range_b)
+{
+    size_t width = 0;
+    auto it_a = std::begin(range_a);
+    auto it_b = std::begin(range_b);
+    for (; it_a != std::end(range_a) && it_b != std::end(range_b); ++it_a, ++it_b)
+    {
+        width = std::max(width, bigint_columns::width(*it_a) + bigint_columns::width(*it_b));
+    }
+    if (it_a != std::end(range_a) || it_b != std::end(range_b))
+    {
+        throw std::invalid_argument("bigint::dot : Ranges have different lengths.");
+    }
+
+    bigint_columns columns(width + 20);
+    it_b = std::begin(range_b);
+    for (it_a = std::begin(range_a); it_a != std::end(range_a); ++it_a, ++it_b)
+    {
+        columns.add_product(*it_a, *it_b);
+    }
+    return columns.to_bigint();
+}
+
+/**
+ * @brief Product of a list of bigints as a balanced product tree.
+ *
+ * Multiplying the factors one after the other makes every product unbalanced, a growing result
+ * times one small factor. The tree multiplies neighbours pairwise instead, so the operands of
+ * each product have similar sizes and large ones use Karatsuba multiplication.
+ *
+ * @param factors The factors.
+ * @param threads Number of threads for the subtrees.
+ * @return The product of the factors, 1 for an empty list.
+ */
+bigint product(const std::vector<bigint> &factors, size_t threads = 1);
+
+/**
+ * @brief Product of a range of bigints as a balanced product tree.
+ *
+ * @tparam Range Any range whose elements convert to bigint.
+ * @param range The factors.
+ * @param threads Number of threads for the subtrees.
+ * @return The product of the factors, 1 for an empty range.
+ */
+template <typename Range>
+bigint product(const Range &range, size_t threads = 1)
+{
+    std::vector<bigint> factors;
+    for (const auto &factor : range)
+    {
+        factors.push_back(factor);
+    }
+    return product(factors, threads);
+}
+
+/**
+ * @brief Binary splitting of a hypergeometric-type series over the terms `[begin, end)`.
+ *
+ * Evaluates `S = sum a(n) * (p(begin) ... p(n)) / (q(begin) ... q(n))` for `begin <= n < end`
+ * exactly, as the triple `(P, Q, T)` with `P = p(begin) ... p(end - 1)`,
+ * `Q = q(begin) ... q(end - 1)` and `S = T / Q`. A single term gives `(p(n), q(n), a(n) p(n))`,
+ * and two adjacent ranges merge as `P = P_l P_r`, `Q = Q_l Q_r` and `T = T_l Q_r + P_l T_r`.
+ * The halves are split at the middle term, so the operands of every product have similar sizes.
+ *
+ * The recursion is depth-first: a subtree is finished and merged before its right sibling
+ * starts, so only one partial triple per level is alive. While more than one thread is
+ * available, the left half runs on a new thread, so at most `threads` subtrees run at once.
+ *
+ * @tparam P Callable `p(uint64_t)` returning a bigint or an integer.
+ * @tparam Q Callable `q(uint64_t)` returning a non-zero bigint or integer.
+ * @tparam A Callable `a(uint64_t)` returning a bigint or an integer.
+ * @param begin First term.
+ * @param end One past the last term.
+ * @param p Numerator of the ratio of consecutive terms.
+ * @param q Denominator of the ratio of consecutive terms.
+ * @param a Coefficient of each term.
+ * @param threads Number of threads for the subtrees; the callbacks must then be thread-safe.
+ * @return The tuple `(P, Q, T)`, and `(1, 1, 0)` for an empty range.
+ */
+template <typename P, typename Q, typename A>
+std::tuple<bigint, bigint, bigint> binary_split(uint64_t begin, uint64_t end, const P &p, const Q &q, const A &a, size_t threads = 1)
+{
+    if (begin >= end)
+        return std::make_tuple(bigint(1), bigint(1), bigint(0));
+    if (end - begin == 1)
+    {
+        bigint p_n = bigint(p(begin));
+        bigint t_n = p_n * bigint(a(begin));
+        return std::make_tuple(p_n, bigint(q(begin)), t_n);
+    }
+
+    uint64_t mid = begin + (end - begin) / 2;
+    std::tuple<bigint, bigint, bigint> left;
+    std::tuple<bigint, bigint, bigint> right;
+    if (threads > 1 && end - begin >= 16)
+    {
+        std::thread worker([&]()
+                           { left = binary_split(begin, mid, p, q, a, threads / 2); });
+        right = binary_split(mid, end, p, q, a, threads - threads / 2);
+        worker.join();
+    }
+    else
+    {
+        left = binary_split(begin, mid, p, q, a, 1);
+        right = binary_split(mid, end, p, q, a, 1);
+    }
+
+    bigint &p_left = std::get<0>(left);
+    bigint &q_left = std::get<1>(left);
+    bigint &t_left = std::get<2>(left);
+    bigint &p_right = std::get<0>(right);
+    bigint &q_right = std::get<1>(right);
+    bigint &t_right = std::get<2>(right);
+    bigint t_merged = t_left * q_right + p_left * t_right;
+    return std::make_tuple(p_left * p_right, q_left * q_right, t_merged);
+}
+
+/**
+ * @brief Uniform random integer of a given bit length.
+ *
+ * Draws 32-bit words with `std::uniform_int_distribution`, masks the top word and converts the
+ * words to decimal once, without going through strings.
+ *
+ * @param bits Number of random bits.
+ * @param urbg Any uniform random bit generator.
+ * @return A uniform value in `[0, 2^bits)`.
+ */
+template <typename URBG>
+bigint random_bits(uint64_t bits, URBG &urbg)
+{
+    std::uniform_int_distribution<uint32_t> word;
+    std::vector<uint32_t> words(static_cast<size_t>((bits + 31) / 32));
+    for (uint32_t &w : words)
+    {
+        w = word(urbg);
+    }
+    if (bits % 32 != 0)
+        words.back() &= (uint32_t(1) << (bits % 32)) - 1;
+    while (!words.empty() && words.back() == 0)
+    {
+        words.pop_back();
+    }
+    return bigint::from_words(words, false);
+}
+
+/**
+ * @brief Uniform random integer below a bound, generated directly in decimal digits.
+ *
+ * The leading `k <= 18` digits of the bound form a word `T`. Each attempt draws the leading word
+ * uniformly from `[0, T]` and the other digits 18 at a time from `[0, 10^18)`, and is accepted
+ * unless the leading word equals `T` and the rest is not below the bound, so every value below the
+ * bound is equally likely and at least half of the attempts succeed.
+ *
+ * @param bound The exclusive upper bound.
+ * @param urbg Any uniform random bit generator.
+ * @return A uniform value in `[0, bound)`.
+ * @throws std::invalid_argument if the bound is not positive.
+ */
+template <typename URBG>
+bigint random_below(const bigint &bound, URBG &urbg)
+{
+    if (bound <= bigint(0))
+    {
+        throw std::invalid_argument("random_below : Bound must be positive.");
+    }
+    const uint64_t chunk_base = 1000000000000000000ULL;
+    size_t skip = 0;
+    while (bound.digits[skip] == 0)
+    {
+        ++skip;
+    }
+    size_t len = bound.digits.size() - skip;
+    size_t head = std::min<size_t>(len, 18);
+    uint64_t top = 0;
+    for (size_t i = 0; i < head; i++)
+    {
+        top = top * 10 + bound.digits[skip + i];
+    }
+    std::uniform_int_distribution<uint64_t> leading(0, top);
+    std::uniform_int_distribution<uint64_t> chunk(0, chunk_base - 1);
+
+    std::vector<uint8_t> digits(len);
+    while (true)
+    {
+        uint64_t value = leading(urbg);
+        bool tight = value == top;
+        for (size_t i = head; i-- > 0;)
+        {
+            digits[i] = static_cast<uint8_t>(value % 10);
+            value /= 10;
+        }
+        for (size_t i = head; i < len; i += 18)
+        {
+            uint64_t part = chunk(urbg);
+            for (size_t j = std::min(len, i + 18); j-- > i;)
+            {
+                digits[j] = static_cast<uint8_t>(part % 10);
+                part /= 10;
+            }
+        }
+        if (tight)
+        {
+            // the leading digits match the bound, so the tail decides
+            size_t i = head;
+            while (i < len && digits[i] == bound.digits[skip + i])
+            {
+                ++i;
+            }
+            if (i == len || digits[i] > bound.digits[skip + i])
+                continue;
+        }
+        break;
+    }
+
+    bigint result;
+    size_t first = 0;
+    while (first < len && digits[first] == 0)
+    {
+        ++first;
+    }
+    if (first < len)
+        result.digits.assign(digits.begin() + static_cast<std::ptrdiff_t>(first), digits.end());
+    return result;
+}
+
+/**
+ * @brief Uniform random integer in a closed range, like `std::uniform_int_distribution`.
+ *
+ * @param low The smallest value.
+ * @param high The largest value.
+ * @param urbg Any uniform random bit generator.
+ * @return A uniform value in `[low, high]`.
+ * @throws std::invalid_argument if `low > high`.
+ */
+template <typename URBG>
+bigint random_range(const bigint &low, const bigint &high, URBG &urbg)
+{
+    if (high < low)
+    {
+        throw std::invalid_argument("random_range : Empty range.");
+    }
+    return low + random_below(high - low + bigint(1), urbg);
+}
+
+/**
+ * @brief Factorial of a machine word.
+ *
+ * The exponent of every prime `p <= n` in `n!` is found with Legendre's formula
+ * `sum floor(n / p^i)`. The prime powers, including the power of two, are combined by
+ * `square()` and balanced products.
+ *
+ * @param n The argument.
+ * @param threads Number of threads for the products.
+ * @return `n!`, with `0! == 1`.
+ */
+bigint factorial(uint64_t n, size_t threads = 1);
+
+/**
+ * @brief Binomial coefficient of machine words.
+ *
+ * With `k <= n / 2`, the numerator terms `n - k + 1, ..., n` are stripped of every prime
+ * `p <= k`, counting the factors removed. Each such prime keeps that count minus its Legendre
+ * exponent in `k!`, so no division by a bigint is ever needed. The stripped terms and the
+ * remaining prime powers are multiplied as balanced products.
+ *
+ * @param n The size of the set.
+ * @param k The size of the subsets.
+ * @param threads Number of threads for the products.
+ * @return `n! / (k! (n - k)!)`, 0 if `k > n`.
+ */
+bigint binomial(uint64_t n, uint64_t k, size_t threads = 1);
+
+/**
+ * @brief Accumulator for summing long streams of integers with lazy carries.
+ *
+ * Small terms are first added to a running `int64_t` that is only spread into digit columns when
+ * the next term would overflow it, so adding an `int64_t` is O(1) amortised. Bigint terms are added
+ * column by column without propagating carries. Independent accumulators, e.g. one per thread,
+ * can be merged with `+=` and the exact total is only normalised when `to_bigint()` is called.
+ * A single accumulator is not safe to update from several threads at once.
+ */
+class bigint_accumulator
+{
+private:
+    bigint_columns columns; ///< Column sums of all terms that have been spread out.
+    int64_t pending;        ///< Running sum of small terms not yet added to the columns.
+
+public:
+    /**
+     * @brief Creates an accumulator holding 0.
+     *
+     */
+    bigint_accumulator();
+
+    /**
+     * @brief Adds a signed 64-bit integer.
+     *
+     * @param n The integer to add.
+     * @return Reference to the updated accumulator.
+     */
+    bigint_accumulator &operator+=(int64_t n);
+    /**
+     * @brief Subtracts a signed 64-bit integer.
+     *
+     * @param n The integer to subtract.
+     * @return Reference to the updated accumulator.
+     */
+    bigint_accumulator &operator-=(int64_t n);
+    /**
+     * @brief Adds a bigint.
+     *
+     * @param n The bigint to add.
+     * @return Reference to the updated accumulator.
+     */
+    bigint_accumulator &operator+=(bigint const &n);
+    /**
+     * @brief Subtracts a bigint.
+     *
+     * @param n The bigint to subtract.
+     * @return Reference to the updated accumulator.
+     */
+    bigint_accumulator &operator-=(bigint const &n);
+    /**
+     * @brief Merges the total of another accumulator into this one.
+     *
+     * @param other The partial accumulator, e.g. from another thread.
+     * @return Reference to the updated accumulator.
+     */
+    bigint_accumulator &operator+=(bigint_accumulator const &other);
+
+    /**
+     * @brief Normalises the accumulated total.
+     *
+     * @return The exact sum of all terms.
+     */
+    bigint to_bigint() const;
+};
+
+/**
+ * @brief Precomputed divisor for repeated division of many numbers by the same value.
+ *
+ * The absolute value of the divisor is packed into limbs of 9 decimal digits and normalised so its
+ * leading limb is at least half the limb base, and a reciprocal of that leading limb is computed
+ * once. Every quotient limb is then estimated with one multiplication by the reciprocal instead of
+ * a hardware division, and corrected with the next limb as in Knuth's algorithm D. Divisors below
+ * 10^9 take a single-limb path that divides nine digits per step by the invariant reciprocal.
+ * Division truncates toward zero and the remainder has the sign of the dividend, as for `int64_t`.
+ */
+class bigint_divisor
+{
+private:
+    static const uint64_t limb_base = 1000000000; ///< Radix of the internal limbs.
+    static const size_t limb_digits = 9;          ///< Decimal digits per limb.
+
+    /**
+     * @brief Reciprocal of an invariant divisor below 2^32 for numerators below 2^60.
+     *
+     * Uses `q = (n * magic) >> (60 + shift)` with `magic = ceil(2^(60 + shift) / d)` and
+     * `shift = ceil(log2(d))`, which is exact for every numerator below 2^60 (Granlund and
+     * Montgomery). Falls back to hardware division without 128-bit integer support.
+     */
+    struct reciprocal
+    {
+        uint64_t divisor; ///< The invariant divisor d.
+        uint64_t magic;   ///< ceil(2^(60 + shift) / d).
+        unsigned shift;   ///< ceil(log2(d)).
+
+        /**
+         * @brief Precomputes the reciprocal of a divisor.
+         *
+         * @param d The divisor, in [1, 2^32).
+         */
+        explicit reciprocal(uint64_t d = 1);
+        /**
+         * @brief Divides by the invariant divisor.
+         *
+         * @param n The numerator, below 2^60.
+         * @return `n / d`.
+         */
+        uint64_t divide(uint64_t n) const;
+    };
+
+    bigint divisor;              ///< The divisor as given.
+    std::vector<uint64_t> limbs; ///< Normalised limbs of |divisor| * factor, least significant first.
+    uint64_t factor;             ///< Normalisation factor of algorithm D.
+    reciprocal top;              ///< Reciprocal of the leading normalised limb, or of |divisor| if it is one limb.
+
+    /**
+     * @brief Packs the absolute value of a bigint into limbs.
+     *
+     * @param n The bigint to pack.
+     * @return Limbs of 9 digits, least significant first; empty for 0.
+     */
+    static std::vector<uint64_t> pack(const bigint &n);
+    /**
+     * @brief Unpacks limbs into a bigint.
+     *
+     * @param in Limbs, least significant first.
+     * @param negative Sign of the result.
+     * @return The value of the limbs.
+     */
+    static bigint unpack(const std::vector<uint64_t> &in, bool negative);
+    /**
+     * @brief Divides the absolute value of `a` by the absolute value of the divisor.
+     *
+     * @param a The dividend.
+     * @param quotient Receives the quotient limbs, or is skipped if null.
+     * @param remainder Receives the remainder limbs.
+     */
+    void run(const bigint &a, std::vector<uint64_t> *quotient, std::vector<uint64_t> &remainder) const;
+    /**
+     * @brief Least significant decimal digit of a bigint.
+     *
+     * @param n The bigint.
+     * @return The last digit, 0 for an empty digit vector.
+     */
+    static uint8_t last_digit(const bigint &n);
+    /**
+     * @brief Divides limbs by a small number in place.
+     *
+     * @param limbs Limbs of 9 digits, least significant first; leading zero limbs are removed.
+     * @param d The divisor, below `2^34`.
+     * @return The remainder.
+     */
+    static uint64_t divide_limbs(std::vector<uint64_t> &limbs, uint64_t d);
+    /**
+     * @brief Divides both operands by the zero limbs and the factors 2 and 5 of the divisor.
+     *
+     * @param u Limbs of the dividend.
+     * @param v Limbs of the nonzero divisor; on return its low limb is coprime to 10.
+     * @return False if a removed factor leaves a remainder in `u`, so `v` cannot divide it.
+     */
+    static bool strip_factors(std::vector<uint64_t> &u, std::vector<uint64_t> &v);
+    /**
+     * @brief Hensel division from the least significant limb up.
+     *
+     * Each step multiplies the lowest remaining limb by the inverse of `v[0]` modulo 10^9 to get
+     * one quotient limb, and subtracts that multiple of `v` so the limb becomes zero.
+     *
+     * @param u Limbs of the dividend. On return the `count` low limbs hold the quotient modulo
+     * `10^(9 count)` and the others the matching limbs of `u - quotient * v`.
+     * @param v Limbs of the divisor, with `v[0]` coprime to 10.
+     * @param count Number of quotient limbs.
+     * @return True if the subtraction borrowed past the top limb of `u`.
+     */
+    static bool hensel(std::vector<uint64_t> &u, const std::vector<uint64_t> &v, size_t count);
+    /**
+     * @brief Computes `a * x + b * y` for limb vectors when the result is known to be non-negative.
+     *
+     * @param a Coefficient of `x`, at most 2^31 in absolute value.
+     * @param x Limbs, least significant first.
+     * @param b Coefficient of `y`, at most 2^31 in absolute value.
+     * @param y Limbs, least significant first.
+     * @return The trimmed limbs of the combination.
+     */
+    static std::vector<uint64_t> combine(int64_t a, const std::vector<uint64_t> &x, int64_t b, const std::vector<uint64_t> &y);
+    /**
+     * @brief Lehmer's greatest common divisor of two magnitudes.
+     *
+     * Runs Euclid's algorithm on the two leading limbs as long as every quotient is certified for
+     * the full operands, then applies the collected 2x2 matrix in one linear pass. When no quotient
+     * can be certified a full division step is taken. Cofactors alternate in sign, so only their
+     * magnitudes and the parity of the step count are kept.
+     *
+     * @param a The larger operand.
+     * @param b The smaller operand, `|b| <= |a|`.
+     * @param s If not null, receives the cofactor of `|a|`.
+     * @param t If not null, receives the cofactor of `|b|`, so that `s * |a| + t * |b| == gcd`.
+     * @return The greatest common divisor of `|a|` and `|b|`.
+     */
+    static bigint lehmer(const bigint &a, const bigint &b, bigint *s, bigint *t);
+
+public:
+    /**
+     * @brief Precomputes the normalised divisor and its reciprocal.
+     *
+     * @param d The divisor.
+     * @throws std::invalid_argument if the divisor is zero.
+     */
+    explicit bigint_divisor(const bigint &d);
+
+    /**
+     * @brief Get the divisor object
+     *
+     * @return The divisor.
+     */
+    const bigint &get_divisor() const;
+
+    /**
+     * @brief Divides a bigint by the divisor.
+     *
+     * @param a The dividend.
+     * @return The quotient, truncated toward zero.
+     */
+    bigint div(const bigint &a) const;
+    /**
+     * @brief Remainder of a bigint divided by the divisor.
+     *
+     * @param a The dividend.
+     * @return The remainder, with the sign of `a`.
+     */
+    bigint mod(const bigint &a) const;
+    /**
+     * @brief Quotient and remainder in one pass.
+     *
+     * @param a The dividend.
+     * @return The pair (quotient, remainder) with `a == quotient * divisor + remainder`.
+     */
+    std::pair<bigint, bigint> divmod(const bigint &a) const;
+
+    /**
+     * @brief Checks whether a bigint is a multiple of the divisor.
+     *
+     * Decided from the last digit alone for the divisors 1, 2, 5 and 10; otherwise only the
+     * remainder is computed and the quotient is never built.
+     *
+     * @param a The bigint to test.
+     * @param d The divisor.
+     * @return True if `d` divides `a`.
+     */
+    friend bool divisible_by(const bigint &a, const bigint_divisor &d);
+    friend bool divisible_by(const bigint &a, const bigint &d);
+    friend bool divisible_by_2exp(const bigint &a, uint64_t k);
+    friend bigint divexact(const bigint &a, const bigint &d);
+    friend bigint gcd(const bigint &a, const bigint &b);
+    friend std::tuple<bigint, bigint, bigint> gcdext(const bigint &a, const bigint &b);
+};
+
+/**
+ * @brief Checks whether a bigint is a multiple of a precomputed divisor.
+ *
+ * @param a The bigint to test.
+ * @param d The divisor.
+ * @return True if `d` divides `a`.
+ */
+bool divisible_by(const bigint &a, const bigint_divisor &d);
+/**
+ * @brief Checks whether a bigint is a multiple of another.
+ *
+ * The last digits decide the factors 2 and 5 and a shorter nonzero `a` is rejected before any
+ * division. Otherwise the `m`-limb Hensel quotient is subtracted from all of `a`, and `d` divides
+ * `a` exactly when nothing is left and nothing was borrowed. This skips the normalisation and the
+ * quotient estimates of `bigint_divisor` but still takes `m * n` limb products.
+ *
+ * @param a The bigint to test.
+ * @param d The divisor.
+ * @return True if `d` divides `a`.
+ * @throws std::invalid_argument if the divisor is 0.
+ */
+bool divisible_by(const bigint &a, const bigint &d);
+/**
+ * @brief Checks whether a bigint is a multiple of `2^k`.
+ *
+ * Since `2^k` divides `10^k`, only the last `k` digits are read. They are halved 29 bits at a time
+ * and the test stops at the first nonzero remainder, so an odd `a` costs one pass over `k` digits.
+ *
+ * @param a The bigint to test.
+ * @param k The exponent.
+ * @return True if `2^k` divides `a`.
+ */
+bool divisible_by_2exp(const bigint &a, uint64_t k);
+/**
+ * @brief Quotient of a division known to be exact.
+ *
+ * Common factors 10, 2 and 5 are divided out of both operands so the divisor is coprime to 10.
+ * For an `m`-limb quotient the low half of its limbs is then found from the least significant limb
+ * up by Hensel division: each limb is the current low limb times the inverse of the divisor's low
+ * limb modulo 10^9, with no estimate and no correction. The high half comes from a truncated
+ * division of the top limbs of `a` by the top `m / 2 + 1` limbs of `d`, which is off by less than
+ * two units in its last limb; one overlapping Hensel limb corrects it. Both halves cost about
+ * `m^2 / 4` limb products, against `m * n` for `bigint_divisor::div` with an `n`-limb divisor.
+ * Measured against a prepared `bigint_divisor`, balanced operands of 3000 to 10000 digits divide
+ * 2.1 to 2.4 times faster and a divisor much longer than the quotient about 5 times faster. A
+ * divisor shorter than half the quotient uses Hensel division alone, which is only about 1.2 times
+ * faster.
+ *
+ * @param a The dividend, a multiple of `d`.
+ * @param d The divisor.
+ * @return `a / d`; unspecified if `d` does not divide `a`.
+ * @throws std::invalid_argument if the divisor is 0.
+ */
+bigint divexact(const bigint &a, const bigint &d);
+
+/**
+ * @brief Greatest common divisor.
+ *
+ * Uses Lehmer's algorithm on limbs of 9 decimal digits and finishes with binary GCD once both
+ * operands fit in a machine word.
+ *
+ * @param a The first bigint.
+ * @param b The second bigint.
+ * @return The non-negative greatest common divisor; `gcd(0, 0) == 0`.
+ */
+bigint gcd(const bigint &a, const bigint &b);
+/**
+ * @brief Least common multiple.
+ *
+ * @param a The first bigint.
+ * @param b The second bigint.
+ * @return The non-negative least common multiple; 0 if either operand is 0.
+ */
+bigint lcm(const bigint &a, const bigint &b);
+/**
+ * @brief Extended greatest common divisor.
+ *
+ * @param a The first bigint.
+ * @param b The second bigint.
+ * @return The tuple (g, x, y) with `a * x + b * y == g == gcd(a, b)`. The coefficients are the
+ *         ones produced by Euclid's algorithm, so `|x| <= |b| / g` and `|y| <= |a| / g`.
+ */
+std::tuple<bigint, bigint, bigint> gcdext(const bigint &a, const bigint &b);
+/**
+ * @brief Modular inverse.
+ *
+ * @param a The bigint to invert.
+ * @param n The modulus.
+ * @return The value `x` in `[0, n)` with `a * x == 1 (mod n)`.
+ * @throws std::invalid_argument if the modulus is not positive or `a` is not coprime to it.
+ */
+bigint invmod(const bigint &a, const bigint &n);
+
+/**
+ * @brief Integer square root.
+ *
+ * @param n The radicand.
+ * @return The largest `s` with `s * s <= n`.
+ * @throws std::invalid_argument if `n` is negative.
+ */
+bigint isqrt(const bigint &n);
+/**
+ * @brief Integer square root with remainder.
+ *
+ * @param n The radicand.
+ * @return The pair (s, r) with `s = isqrt(n)` and `n == s * s + r`.
+ * @throws std::invalid_argument if `n` is negative.
+ */
+std::pair<bigint, bigint> isqrt_rem(const bigint &n);
+/**
+ * @brief Integer k-th root, truncated toward zero.
+ *
+ * @param n The radicand; may be negative for odd `k`.
+ * @param k The root index.
+ * @return The k-th root of `|n|` rounded down, with the sign of `n`.
+ * @throws std::invalid_argument if `k` is 0, or `k` is even and `n` is negative.
+ */
+bigint iroot(const bigint &n, uint64_t k);
+/**
+ * @brief Checks whether a bigint is a perfect square.
+ *
+ * Residues modulo 64, 63, 65 and 11 reject most non-squares before any root is taken.
+ *
+ * @param n The bigint to test.
+ * @return True if `n == s * s` for some integer `s`.
+ */
+bool is_perfect_square(const bigint &n);
+/**
+ * @brief Checks whether a bigint is a perfect power.
+ *
+ * Every prime exponent up to the bit length is tried. Before the root is computed, the residue
+ * modulo small primes `p` with `p % k == 1` must be a k-th power residue, which rejects all but
+ * about one candidate in `k`.
+ *
+ * @param n The bigint to test.
+ * @return True if `n == m^k` for some integers `m` and `k >= 2`; 0, 1 and -1 are perfect powers.
+ */
+bool is_perfect_power(const bigint &n);
+/**
+ * @brief Baillie-PSW probable prime test.
+ *
+ * Trial division by the primes below 1000 settles every candidate below 10^6. Larger candidates
+ * must pass a Miller-Rabin round to base 2 and a strong Lucas test; no composite passing both is
+ * known.
+ *
+ * @param n The candidate.
+ * @return False if `n` is composite or below 2; true if `n` is prime or a probable prime.
+ */
+bool is_probable_prime(const bigint &n);
+/**
+ * @brief Baillie-PSW probable prime test followed by extra Miller-Rabin rounds.
+ *
+ * @param n The candidate.
+ * @param rounds Number of additional Miller-Rabin rounds, to the small prime bases 3, 5, 7, ...
+ * @return False if `n` is composite or below 2; true if `n` is prime or a probable prime.
+ */
+bool is_probable_prime(const bigint &n, uint64_t rounds);
+/**
+ * @brief Smallest probable prime greater than a bigint.
+ *
+ * Candidates are sieved in windows of odd numbers by the primes below 10000, so only survivors
+ * reach `is_probable_prime`.
+ *
+ * @param n The starting point.
+ * @return The smallest probable prime greater than `n`.
+ */
+bigint next_prime(const bigint &n);
+
+/**
+ * @brief Montgomery arithmetic modulo a fixed modulus coprime to 10.
+ *
+ * Internally values are packed into limbs of 6 decimal digits, so the Montgomery radix is
+ * `R = 10^(6k)` where `k` is the number of limbs of the modulus, and the modulus must be coprime to
+ * 10 (odd and not a multiple of 5). The constructor precomputes `-N^-1 mod 10^6`, `R mod N` and
+ * `R^2 mod N`; afterwards every reduction is a limb-serial REDC without any division. Column sums
+ * stay exact for moduli up to about 27 million digits. Scratch buffers are kept in the context and
+ * reused by every call, so a context must not be used from several threads at once.
+ */
+class modular_context
+{
+private:
+    static const int64_t limb_base = 1000000; ///< Radix of the internal limbs.
+    static const size_t limb_digits = 6;      ///< Decimal digits per limb.
+
+    bigint modulus;                      ///< The modulus N.
+    bigint_divisor reducer;              ///< Precomputed division by N, used to reduce inputs.
+    std::vector<int64_t> modulus_limbs;  ///< Limbs of N, least significant first.
+    size_t width;                        ///< Number of limbs k of N, so R = 10^(6k).
+    int64_t inverse;                     ///< -N^-1 mod 10^6.
+    std::vector<int64_t> one;            ///< R mod N, i.e. 1 in Montgomery form.
+    std::vector<int64_t> r_squared;      ///< R^2 mod N.
+
+    mutable std::vector<int64_t> scratch;   ///< Column sums reused by every REDC.
+    mutable std::vector<int64_t> operand_a; ///< Limb buffer reused for the first operand.
+    mutable std::vector<int64_t> operand_b; ///< Limb buffer reused for the second operand.
+    mutable std::vector<int64_t> product;   ///< Limb buffer reused for the unreduced REDC result.
+    mutable std::vector<int64_t> reduced;   ///< Limb buffer reused for the REDC result minus N.
+
+    /**
+     * @brief Reduces a bigint modulo N into a padded limb buffer.
+     *
+     * @param n The value to reduce; may be negative or larger than N.
+     * @param out Receives the `k` limbs of `n mod N`, least significant first.
+     */
+    void load(const bigint &n, std::vector<int64_t> &out) const;
+    /**
+     * @brief Packs the digits of a non-negative bigint below `R` into `k` limbs.
+     *
+     * @param n The value to pack.
+     * @param out Receives the limbs, least significant first.
+     */
+    void pack(const bigint &n, std::vector<int64_t> &out) const;
+    /**
+     * @brief Converts a padded limb buffer back to a bigint.
+     *
+     * @param in Limbs, least significant first.
+     * @return The value of the buffer.
+     */
+    static bigint store(const std::vector<int64_t> &in);
+    /**
+     * @brief Montgomery product `a * b * R^-1 mod N` of two padded limb buffers.
+     *
+     * The sequence of operations only depends on `k`, and the final conditional subtraction is
+     * done with a mask instead of a branch. Passing the same buffer as `a` and `b` squares it,
+     * computing each cross product once.
+     *
+     * @param a The first operand, `k` limbs in [0, N).
+     * @param b The second operand, `k` limbs in [0, N).
+     * @param out Receives the `k` limbs of the result; may alias `a` or `b`.
+     */
+    void redc(const std::vector<int64_t> &a, const std::vector<int64_t> &b, std::vector<int64_t> &out) const;
+
+public:
+    /**
+     * @brief Precomputes the Montgomery constants of a modulus.
+     *
+     * @param n The modulus.
+     * @throws std::invalid_argument if the modulus is not positive or not coprime to 10.
+     */
+    explicit modular_context(const bigint &n);
+
+    /**
+     * @brief Get the modulus object
+     *
+     * @return The modulus N.
+     */
+    const bigint &get_modulus() const;
+
+    /**
+     * @brief Converts a value to Montgomery form.
+     *
+     * @param a Any bigint; it is reduced modulo N first.
+     * @return `a * R mod N`.
+     */
+    bigint to_montgomery(const bigint &a) const;
+    /**
+     * @brief Converts a value out of Montgomery form.
+     *
+     * @param a A value in Montgomery form.
+     * @return `a * R^-1 mod N`.
+     */
+    bigint from_montgomery(const bigint &a) const;
+
+    /**
+     * @brief Multiplies two values in Montgomery form.
+     *
+     * @param a The first operand in Montgomery form.
+     * @param b The second operand in Montgomery form.
+     * @return The product in Montgomery form.
+     */
+    bigint mulmod(const bigint &a, const bigint &b) const;
+    /**
+     * @brief Squares a value in Montgomery form.
+     *
+     * @param a The operand in Montgomery form.
+     * @return The square in Montgomery form.
+     */
+    bigint sqrmod(const bigint &a) const;
+    /**
+     * @brief Modular exponentiation `base^exponent mod N`.
+     *
+     * Takes and returns ordinary (non-Montgomery) values. The default path uses a sliding window
+     * over the exponent bits. With `constant_time`, a fixed 4-bit window is used, every window
+     * multiplies by a table entry (the entry for 0 is 1) and entries are read by scanning the whole
+     * table with masks, so the operation sequence only depends on the sizes of N and the exponent.
+     *
+     * @param base The base; it is reduced modulo N first.
+     * @param exponent The exponent.
+     * @param constant_time True to avoid exponent-dependent branches and memory accesses.
+     * @return `base^exponent mod N`, in [0, N).
+     * @throws std::invalid_argument if the exponent is negative.
+     */
+    bigint powmod(const bigint &base, const bigint &exponent, bool constant_time = false) const;
+};
+
+/**
+ * @brief Many bigints of similar size in a structure-of-arrays layout, with batch kernels.
+ *
+ * Values are stored as `width` limbs of 9 decimal digits in radix complement, so a value `v` is
+ * kept as `v mod 10^(9 width)` and is negative when its top limb is at least 10^9 / 2. Limb `l`
+ * of every value is contiguous, so each kernel walks one limb row at a time over all numbers with
+ * a per-number carry. The inner loops run across numbers, which lets the compiler vectorize them,
+ * and signs need no branches: addition and subtraction are plain complement arithmetic.
+ * Each kernel can split the numbers across threads.
+ */
+class bigint_batch
+{
+private:
+    static const uint32_t limb_base = 1000000000; ///< Radix of the limbs.
+    static const size_t limb_digits = 9;          ///< Decimal digits per limb.
+
+    size_t count;                ///< Number of values.
+    size_t limbs_per_value;      ///< Limbs per value.
+    std::vector<uint32_t> limbs; ///< Limb `l` of value `i` at `l * count + i`.
+
+    /**
+     * @brief Checks the sign of a value.
+     *
+     * @param i Index of the value.
+     * @return True if value `i` is negative.
+     */
+    bool negative(size_t i) const;
+    /**
+     * @brief Sign-extension limbs of every value.
+     *
+     * @param begin First value.
+     * @param end One past the last value.
+     * @return `10^9 - 1` for negative values and 0 otherwise, indexed by value.
+     */
+    std::vector<uint32_t> fill(size_t begin, size_t end) const;
+    /**
+     * @brief Absolute values of a range of values, in the same layout with `end - begin` columns.
+     *
+     * @param begin First value.
+     * @param end One past the last value.
+     * @return The magnitudes, limb `l` of value `begin + i` at `l * (end - begin) + i`.
+     */
+    std::vector<uint32_t> magnitudes(size_t begin, size_t end) const;
+    /**
+     * @brief Negates, in place, the values of a range whose flag is set.
+     *
+     * @param flags One flag per value of the range.
+     * @param begin First value.
+     * @param end One past the last value.
+     */
+    void negate(const std::vector<uint8_t> &flags, size_t begin, size_t end);
+    /**
+     * @brief Kernel of add and sub for a range of values: `*this = a + b` or `a - b`.
+     *
+     * @param a The first operand batch.
+     * @param b The second operand batch.
+     * @param subtract True to compute `a - b`.
+     * @param begin First value.
+     * @param end One past the last value.
+     */
+    void add_range(const bigint_batch &a, const bigint_batch &b, bool subtract, size_t begin, size_t end);
+    /**
+     * @brief Kernel of mul for a range of values: `*this = a * b`.
+     *
+     * @param a The first operand batch.
+     * @param b The second operand batch.
+     * @param begin First value.
+     * @param end One past the last value.
+     */
+    void mul_range(const bigint_batch &a, const bigint_batch &b, size_t begin, size_t end);
+    /**
+     * @brief Kernel of mod for a range of values: `*this = a mod m`.
+     *
+     * @param a The operand batch.
+     * @param m Limbs of the modulus, least significant first, without leading zeros.
+     * @param begin First value.
+     * @param end One past the last value.
+     */
+    void mod_range(const bigint_batch &a, const std::vector<uint32_t> &m, size_t begin, size_t end);
+
+    friend class bigint_rns;
+
+    /**
+     * @brief Runs a kernel over all values, split into contiguous ranges across threads.
+     *
+     * @param count Number of values.
+     * @param threads Number of threads; 0 and 1 run on the calling thread.
+     * @param kernel Callable invoked as `kernel(begin, end)` for each range.
+     */
+    template <typename Kernel>
+    static void parallel(size_t count, size_t threads, Kernel kernel)
+    {
+        threads = std::max<size_t>(1, std::min(threads, count));
+        if (threads == 1)
+        {
+            kernel(size_t(0), count);
+            return;
+        }
+        std::vector<std::thread> workers;
+        size_t chunk = (count + threads - 1) / threads;
+        for (size_t begin = 0; begin < count; begin += chunk)
+        {
+            workers.emplace_back(kernel, begin, std::min(count, begin + chunk));
+        }
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+public:
+    /**
+     * @brief Creates a batch of zeros.
+     *
+     * @param count Number of values.
+     * @param width Limbs per value; values must satisfy `|v| < 10^(9 width) / 2`.
+     */
+    bigint_batch(size_t count, size_t width);
+    /**
+     * @brief Creates a batch from bigints, one limb wider than the widest value.
+     *
+     * @param values The values.
+     */
+    explicit bigint_batch(const std::vector<bigint> &values);
+
+    /**
+     * @brief Number of values.
+     *
+     * @return The number of values.
+     */
+    size_t size() const;
+    /**
+     * @brief Limbs per value.
+     *
+     * @return The width of every value in limbs of 9 digits.
+     */
+    size_t width() const;
+    /**
+     * @brief Reads one value.
+     *
+     * @param i Index of the value.
+     * @return Value `i`.
+     */
+    bigint get(size_t i) const;
+    /**
+     * @brief Writes one value.
+     *
+     * @param i Index of the value.
+     * @param value The new value.
+     * @throws std::invalid_argument if the value does not fit in the width.
+     */
+    void set(size_t i, const bigint &value);
+    /**
+     * @brief Converts every value back to a bigint.
+     *
+     * @return The values in order.
+     */
+    std::vector<bigint> to_vector() const;
+
+    /**
+     * @brief Element-wise sum, one limb wider than the wider operand.
+     *
+     * @param other The other batch, with the same number of values.
+     * @param threads Number of threads.
+     * @return The batch of `this[i] + other[i]`.
+     * @throws std::invalid_argument if the batches have different sizes.
+     */
+    bigint_batch add(const bigint_batch &other, size_t threads = 1) const;
+    /**
+     * @brief Element-wise difference, one limb wider than the wider operand.
+     *
+     * @param other The other batch, with the same number of values.
+     * @param threads Number of threads.
+     * @return The batch of `this[i] - other[i]`.
+     * @throws std::invalid_argument if the batches have different sizes.
+     */
+    bigint_batch sub(const bigint_batch &other, size_t threads = 1) const;
+    /**
+     * @brief Element-wise product, as wide as both operands together.
+     *
+     * Magnitudes are multiplied row by row with a per-number carry, and the products of values
+     * with different signs are negated at the end.
+     *
+     * @param other The other batch, with the same number of values.
+     * @param threads Number of threads.
+     * @return The batch of `this[i] * other[i]`.
+     * @throws std::invalid_argument if the batches have different sizes.
+     */
+    bigint_batch mul(const bigint_batch &other, size_t threads = 1) const;
+    /**
+     * @brief Element-wise comparison.
+     *
+     * @param other The other batch, with the same number of values.
+     * @param threads Number of threads.
+     * @return -1, 0 or 1 for each value, as `this[i]` is less than, equal to or greater than `other[i]`.
+     * @throws std::invalid_argument if the batches have different sizes.
+     */
+    std::vector<int> compare(const bigint_batch &other, size_t threads = 1) const;
+    /**
+     * @brief Reduces every value modulo one positive modulus.
+     *
+     * Runs long division limb by limb for all numbers at once. Each quotient limb is estimated in
+     * floating point from the leading limbs, which is off by at most two, and fixed by masked
+     * add-backs and subtractions that do not branch on the data.
+     *
+     * @param m The modulus.
+     * @param threads Number of threads.
+     * @return The batch of `this[i] mod m` in `[0, m)`, one limb wider than `m`.
+     * @throws std::invalid_argument if the modulus is not positive.
+     */
+    bigint_batch mod(const bigint &m, size_t threads = 1) const;
+};
+
+/**
+ * @brief A bigint as residues modulo a set of word-sized primes, for long chains of additions,
+ * subtractions and multiplications whose final result is bounded.
+ *
+ * The moduli are the largest primes below 2^31, as many as needed for their product `M` to exceed
+ * `2^(bits + 1)`. Each operation works on every residue independently, with no carries between
+ * them, so the loops vectorize and split across threads. Intermediate values may grow without
+ * limit; only the final result must satisfy `|v| < 2^bits`, and `to_bigint()` rebuilds it with
+ * Garner's mixed-radix CRT and a product tree. Values share their basis, so only values created
+ * from the same basis can be combined.
+ */
+class bigint_rns
+{
+private:
+    /**
+     * @brief Moduli and CRT constants shared by all values of one basis.
+     *
+     */
+    struct basis
+    {
+        uint64_t bits;                  ///< Bound on the absolute value of results, in bits.
+        std::vector<uint32_t> moduli;   ///< The primes, largest first.
+        std::vector<uint32_t> inverses; ///< `(m_0 ... m_(i-1))^-1 mod m_i` for Garner's algorithm.
+        std::vector<bigint> products;   ///< Product tree of the moduli: node 1 covers all, node `n` splits into `2n` and `2n + 1`.
+
+        /**
+         * @brief Finds the primes by sieving windows below 2^31 and precomputes the CRT constants.
+         *
+         * @param bits Bound on the absolute value of results, in bits.
+         * @throws std::invalid_argument if the bound needs more primes than lie between 2^30 and 2^31.
+         */
+        explicit basis(uint64_t bits);
+        /**
+         * @brief Fills the product tree below one node.
+         *
+         * @param node Index of the node.
+         * @param begin First modulus of the node.
+         * @param end One past the last modulus of the node.
+         */
+        void build(size_t node, size_t begin, size_t end);
+    };
+
+    std::shared_ptr<const basis> shared; ///< The basis of the value.
+    std::vector<uint32_t> residues;      ///< The value modulo each prime, in the order of the moduli.
+
+    /**
+     * @brief Creates a zero value on a basis.
+     *
+     * @param shared The basis.
+     */
+    explicit bigint_rns(std::shared_ptr<const basis> shared);
+    /**
+     * @brief Computes the residues of a bigint, splitting the moduli across threads.
+     *
+     * @param value The value.
+     * @param threads Number of threads.
+     */
+    void load(const bigint &value, size_t threads);
+    /**
+     * @brief Checks that two values share a basis.
+     *
+     * @param other The other value.
+     * @param function Name of the calling function, for the exception message.
+     * @throws std::invalid_argument if the bases differ.
+     */
+    void check_basis(const bigint_rns &other, const char *function) const;
+    /**
+     * @brief Rebuilds the mixed-radix number `c_begin + m_begin (c_(begin+1) + ...)` over one node of the product tree.
+     *
+     * @param digits Garner's mixed-radix digits.
+     * @param node Index of the node.
+     * @param begin First digit of the node.
+     * @param end One past the last digit of the node.
+     * @param threads Number of threads.
+     * @return The value of the node.
+     */
+    bigint combine(const std::vector<uint32_t> &digits, size_t node, size_t begin, size_t end, size_t threads) const;
+
+public:
+    /**
+     * @brief Converts a bigint onto a new basis.
+     *
+     * Building the basis costs `O(k^2)` word operations and a product tree of the `k` moduli; use
+     * the other constructor to put further values on the same basis.
+     *
+     * @param value The value.
+     * @param bits Bound on the absolute value of the final results, in bits.
+     * @param threads Number of threads.
+     */
+    bigint_rns(const bigint &value, uint64_t bits, size_t threads = 1);
+    /**
+     * @brief Converts a bigint onto the basis of another value.
+     *
+     * @param value The value.
+     * @param like A value whose basis is reused.
+     * @param threads Number of threads.
+     */
+    bigint_rns(const bigint &value, const bigint_rns &like, size_t threads = 1);
+
+    /**
+     * @brief Number of moduli.
+     *
+     * @return The number of residues per value.
+     */
+    size_t size() const;
+    /**
+     * @brief Bound of the basis.
+     *
+     * @return The bound on the absolute value of results, in bits.
+     */
+    uint64_t bits() const;
+    /**
+     * @brief Reads the residues.
+     *
+     * @return The value modulo each prime.
+     */
+    const std::vector<uint32_t> &get_residues() const;
+    /**
+     * @brief Reads the moduli.
+     *
+     * @return The primes, largest first.
+     */
+    const std::vector<uint32_t> &get_moduli() const;
+
+    /**
+     * @brief Sum of two values.
+     *
+     * @param other The other value, on the same basis.
+     * @param threads Number of threads.
+     * @return `*this + other`.
+     * @throws std::invalid_argument if the bases differ.
+     */
+    bigint_rns add(const bigint_rns &other, size_t threads = 1) const;
+    /**
+     * @brief Difference of two values.
+     *
+     * @param other The other value, on the same basis.
+     * @param threads Number of threads.
+     * @return `*this - other`.
+     * @throws std::invalid_argument if the bases differ.
+     */
+    bigint_rns sub(const bigint_rns &other, size_t threads = 1) const;
+    /**
+     * @brief Product of two values.
+     *
+     * @param other The other value, on the same basis.
+     * @param threads Number of threads.
+     * @return `*this * other`.
+     * @throws std::invalid_argument if the bases differ.
+     */
+    bigint_rns mul(const bigint_rns &other, size_t threads = 1) const;
+    /**
+     * @brief Reconstructs the value with Garner's algorithm.
+     *
+     * The mixed-radix digits cost `O(k^2)` word operations; they are then combined along the
+     * product tree of the moduli, whose halves run on separate threads.
+     *
+     * @param threads Number of threads.
+     * @return The value in `(-M / 2, M / 2]`, which is exact when `|v| < 2^bits`.
+     */
+    bigint to_bigint(size_t threads = 1) const;
+
+    /**
+     * @brief Sum of two values.
+     *
+     * @param other The other value, on the same basis.
+     * @return `*this + other`.
+     */
+    bigint_rns operator+(const bigint_rns &other) const;
+    /**
+     * @brief Difference of two values.
+     *
+     * @param other The other value, on the same basis.
+     * @return `*this - other`.
+     */
+    bigint_rns operator-(const bigint_rns &other) const;
+    /**
+     * @brief Product of two values.
+     *
+     * @param other The other value, on the same basis.
+     * @return `*this * other`.
+     */
+    bigint_rns operator*(const bigint_rns &other) const;
+    /**
+     * @brief Negation.
+     *
+     * @return `-*this`.
+     */
+    bigint_rns operator-() const;
+    /**
+     * @brief Adds in place.
+     *
+     * @param other The other value, on the same basis.
+     * @return Reference to the updated value.
+     */
+    bigint_rns &operator+=(const bigint_rns &other);
+    /**
+     * @brief Subtracts in place.
+     *
+     * @param other The other value, on the same basis.
+     * @return Reference to the updated value.
+     */
+    bigint_rns &operator-=(const bigint_rns &other);
+    /**
+     * @brief Multiplies in place.
+     *
+     * @param other The other value, on the same basis.
+     * @return Reference to the updated value.
+     */
+    bigint_rns &operator*=(const bigint_rns &other);
+    /**
+     * @brief Compares two values modulo `M`.
+     *
+     * @param other The other value, on the same basis.
+     * @return True if all residues are equal.
+     * @throws std::invalid_argument if the bases differ.
+     */
+    bool operator==(const bigint_rns &other) const;
+    /**
+     * @brief Compares two values modulo `M`.
+     *
+     * @param other The other value, on the same basis.
+     * @return True if any residue differs.
+     * @throws std::invalid_argument if the bases differ.
+     */
+    bool operator!=(const bigint_rns &other) const;
+};
+
+BIGINT_CONSTEXPR bigint::bigint()
+{
+    push_back(uint8_t(0));
+    is_negative = false;
+}
+BIGINT_CONSTEXPR bigint::bigint(int64_t n)
+{
+    // negate in unsigned arithmetic so that the minimum converts without overflow
+    uint64_t magnitude = static_cast<uint64_t>(n);
+    if (n < 0)
+    {
+        is_negative = true;
+        magnitude = 0 - magnitude;
+    }
+    else
+    {
+        is_negative = false;
+    }
+    if (magnitude)
+    {
+        while (magnitude)
+        {
+            push_back(static_cast<uint8_t>(magnitude % 10));
+            magnitude /= 10;
+        }
+        std::reverse(begin(), end());
+    }
+    else
+    {
+        push_back(uint8_t(0));
+    }
+}
+BIGINT_CONSTEXPR bigint::bigint(std::string n)
+{
+    BIGINT_RECORD(parse, n.size());
+    if (n[0] == '-')
+    {
+        is_negative = true;
+        n = n.substr(1);
+    }
+    else if (n[0] == '+')
+    {
+        is_negative = false;
+        n = n.substr(1);
+    }
+    else
+    {
+        is_negative = false;
+    }
+    if (n.empty())
+    {
+        throw std::invalid_argument("bigint::bigint : Input string is empty.");
+    }
+
+    n.erase(0, n.find_first_not_of('0'));
+    if (n.empty())
+    {
+        n = "0";
+    }
+    BIGINT_RECORD_BYTES(0, n.size());
+
+    for (char ch : n)
+    {
+        if (ch < '0' || ch > '9')
+        {
+
+            throw std::invalid_argument("bigint::bigint : Invalid character in input string: " + std::string(1, ch));
+        }
+        push_back(static_cast<uint8_t>(ch - '0'));
+    }
+}
+BIGINT_CONSTEXPR bigint::bigint(const bigint &other) : digits(other.digits), is_negative(other.is_negative)
+{
+    BIGINT_RECORD(copy, digits.size());
+    BIGINT_DIGITS_COPIED(digits.size());
+}
+BIGINT_CONSTEXPR bigint::bigint(bigint &&other) noexcept : digits(std::move(other.digits)), is_negative(other.is_negative)
+{
+    // no digits read as 0, so the source is left valid without allocating
+    other.digits.clear();
+    other.is_negative = false;
+}
+// helpers
+
+BIGINT_CONSTEXPR uint8_t bigint::get_digit(const uint64_t n) const
+{
+    return n >= digits.size() ? 0 : digits[n];
+}
+
+BIGINT_CONSTEXPR std::vector<uint8_t> bigint::get_digits() const
+{
+    BIGINT_RECORD(get_digits, digits.size());
+    BIGINT_RECORD_BYTES(digits.size(), digits.size());
+    if (digits.empty())
+        return std::vector<uint8_t>(1, 0);
+    return digits;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::set_digits(std::vector<uint8_t> n)
+{
+    digits = n;
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::push_back(const uint8_t n)
+{
+    digits.push_back(n);
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::pop_back()
+{
+    digits.pop_back();
+    return *this;
+}
+
+BIGINT_CONSTEXPR std::vector<uint8_t>::iterator bigint::begin()
+{
+    return digits.begin();
+}
+
+BIGINT_CONSTEXPR std::vector<uint8_t>::iterator bigint::end()
+{
+    return digits.end();
+}
+
+BIGINT_CONSTEXPR bigint &bigint::insert(std::vector<uint8_t>::iterator ind, const uint8_t num)
+{
+    digits.insert(ind, num);
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::erase(const std::vector<uint8_t>::iterator ind)
+{
+    digits.erase(ind);
+    return *this;
+}
+
+BIGINT_CONSTEXPR size_t bigint::size() const
+{
+    if (is_zero())
+        return 0;
+    size_t length = digits.size();
+    std::size_t startIndex = 0;
+
+    while (startIndex < length && digits[startIndex] == 0)
+    {
+        ++startIndex;
+    }
+    return length - startIndex;
+}
+
+BIGINT_CONSTEXPR bool bigint::get_is_negative() const
+{
+    return is_negative;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::set_negative(bool neg)
+{
+    is_negative = neg;
+    return *this;
+}
+
+// overloaded operators
+BIGINT_CONSTEXPR bigint bigint::operator+(bigint const &other) const
+{
+    BIGINT_RECORD(add, std::max(digits.size(), other.digits.size()));
+    bigint sum;
+
+    if (get_is_negative() == other.get_is_negative())
+    {
+        uint8_t carry = 0;
+        size_t this_len = size();
+        size_t other_len = other.size();
+        size_t len = std::max(this_len, other_len);
+
+        // collect the digits least significant first and reverse once, instead of inserting at the front
+        std::vector<uint8_t> result;
+        result.reserve(len + 1);
+        for (uint64_t i = 0; i < len; i++)
+        {
+            uint8_t sum_i = static_cast<uint8_t>(get_digit(this_len - 1 - i) + other.get_digit(other_len - 1 - i) + carry);
+            carry = static_cast<uint8_t>(sum_i / 10);
+            result.push_back(static_cast<uint8_t>(sum_i % 10));
+        }
+        if (carry > 0 || result.empty())
+            result.push_back(carry);
+        std::reverse(result.begin(), result.end());
+
+        sum.set_negative(get_is_negative());
+        BIGINT_RECORD_BYTES(0, result.size());
+        sum.digits = std::move(result);
+    }
+    else if (get_is_negative())
+    {
+        sum = -(-*this - other);
+    }
+    else
+        sum = *this - (-other);
+
+    return sum;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::operator+=(bigint const &increment)
+{
+    *this = *this + increment;
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::operator++()
+{
+    return *this += bigint(1);
+}
+
+BIGINT_CONSTEXPR bigint bigint::operator++(int)
+{
+    bigint temp = *this;
+    ++(*this);
+    return temp;
+}
+
+BIGINT_CONSTEXPR bigint bigint::operator-(bigint const &other) const
+{
+    BIGINT_RECORD(sub, std::max(digits.size(), other.digits.size()));
+    bigint diff;
+
+    if (get_is_negative() == other.get_is_negative())
+    {
+        diff.set_negative(*this >= other ? 0 : 1);
+
+        bigint pos_num;
+        bigint neg_num;
+
+        if (abs() > other.abs())
+        {
+            pos_num = *this;
+            neg_num = other;
+        }
+        else
+        {
+            pos_num = other;
+            neg_num = *this;
+        }
+
+        size_t pos_len = pos_num.size();
+        size_t neg_len = neg_num.size();
+        size_t len = std::max(pos_len, neg_len);
+        if (len == 0)
+            return bigint(0);
+
+        uint8_t borrow = 0;
+        std::vector<uint8_t> result;
+        result.reserve(len);
+
+        for (uint64_t i = 0; i < len; i++)
+        {
+            uint8_t pos_i = pos_num.get_digit(pos_len - 1 - i);
+            uint8_t neg_i = neg_num.get_digit(neg_len - 1 - i);
+            uint8_t diff_i;
+
+            if (pos_i < (neg_i + borrow))
+            {
+                diff_i = static_cast<uint8_t>(neg_i - pos_i + borrow);
+                borrow = 1;
+                diff_i = static_cast<uint8_t>(10 - diff_i);
+            }
+            else
+            {
+                diff_i = static_cast<uint8_t>(pos_i - neg_i - borrow);
+                borrow = 0;
+            }
+            result.push_back(diff_i);
+        }
+
+        // drop the leading zeros, keeping at least one digit, then restore the most significant first order
+        while (result.size() > 1 && result.back() == 0)
+        {
+            result.pop_back();
+        }
+        std::reverse(result.begin(), result.end());
+        BIGINT_RECORD_BYTES(0, result.size());
+        diff.digits = std::move(result);
+    }
+    else if (get_is_negative())
+    {
+        diff = -(-*this + other);
+    }
+    else
+        diff = *this + (-other);
+    return diff;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::operator-=(bigint const &decrement)
+{
+    *this = *this - decrement;
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::operator--()
+{
+    return *this -= bigint(1);
+}
+
+BIGINT_CONSTEXPR bigint bigint::operator--(int)
+{
+    bigint temp = *this;
+    --(*this);
+    return temp;
+}
+
+BIGINT_CONSTEXPR bigint bigint::operator*(bigint const &other) const
+{
+    BIGINT_SPAN(mul, std::max(digits.size(), other.digits.size()));
+    return multiply(*this, other);
+}
+
+BIGINT_CONSTEXPR bigint &bigint::operator*=(bigint const &multiplier)
+{
+    *this = *this * multiplier;
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint bigint::operator-() const
+{
+    bigint flip = *this;
+    flip.set_negative(!get_is_negative());
+
+    return flip;
+}
+
+BIGINT_CONSTEXPR bigint bigint::abs() const
+{
+    bigint abs = *this;
+    abs.set_negative(0);
+
+    return abs;
+}
+
+BIGINT_CONSTEXPR bool bigint::operator==(bigint const &other) const
+{
+
+    if (get_is_negative() == other.get_is_negative() && digits == other.digits)
+        return true;
+    else
+    {
+        if (is_zero() && other.is_zero())
+            return true;
+        else
+        {
+            return false;
+        }
+    }
+}
+
+BIGINT_CONSTEXPR bool bigint::is_zero() const
+{
+    for (uint8_t digit : digits)
+    {
+        if (digit != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+BIGINT_CONSTEXPR bool bigint::operator!=(bigint const &other) const
+{
+    return !(*this == other);
+}
+
+BIGINT_CONSTEXPR bool bigint::operator<(bigint const &other) const
+{
+    BIGINT_RECORD(compare, std::max(digits.size(), other.digits.size()));
+    if (*this == other)
+        return false;
+    else if (get_is_negative() != other.get_is_negative())
+        return get_is_negative();
+    else if (size() > other.size())
+    {
+        return get_is_negative();
+    }
+    else if (size() == other.size())
+    {
+        for (uint64_t i = 0; i < size(); i++)
+        {
+            if (get_digit(i) != other.get_digit(i))
+                return get_digit(i) > other.get_digit(i) ? get_is_negative() : !get_is_negative();
+        }
+        return false;
+    }
+    else
+        return !get_is_negative();
+}
+
+BIGINT_CONSTEXPR bool bigint::operator>(bigint const &other) const
+{
+    return other < *this;
+}
+BIGINT_CONSTEXPR bool bigint::operator<=(bigint const &other) const
+{
+    return other == *this || *this < other;
+}
+BIGINT_CONSTEXPR bool bigint::operator>=(bigint const &other) const
+{
+    return other == *this || *this > other;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::operator=(const bigint &other)
+{
+    BIGINT_RECORD(copy, other.digits.size());
+    BIGINT_DIGITS_COPIED(other.digits.size());
+    set_negative(other.get_is_negative());
+    digits = other.digits;
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::operator=(bigint &&other) noexcept
+{
+    if (this != &other)
+    {
+        digits = std::move(other.digits);
+        is_negative = other.is_negative;
+        other.digits.clear();
+        other.is_negative = false;
+    }
+    return *this;
+}
+
+std::ostream &operator<<(std::ostream &os, const bigint &n)
+{
+    BIGINT_RECORD(print, n.digits.size());
+    if (n.get_is_negative())
+    {
+        os << '-';
+    }
+    // a moved-from value has no digits and is 0
+    if (n.digits.empty())
+        return os << '0';
+    for (uint8_t digit : n.digits)
+    {
+        os << static_cast<uint16_t>(digit);
+    }
+    return os;
+}
+
+BIGINT_CONSTEXPR bigint operator""_big(const char *n)
+{
+    std::string literal;
+    for (; *n != '\0'; ++n)
+    {
+        if (*n != '\'')
+            literal.push_back(*n);
+    }
+    return bigint(literal);
+}
+
+BIGINT_CONSTEXPR bigint_columns::bigint_columns(size_t width) : load(0)
+{
+    columns.reserve(width + 1);
+}
+
+BIGINT_CONSTEXPR void bigint_columns::reserve_load(uint64_t growth)
+{
+    // keep every column sum well inside int64_t, including the carry it receives
+    const uint64_t limit = uint64_t(1) << 62;
+    if (load + growth > limit)
+    {
+        propagate(columns);
+        load = 10;
+    }
+    load += growth;
+}
+
+BIGINT_CONSTEXPR size_t bigint_columns::width(const bigint &n)
+{
+    return n.digits.size();
+}
+
+BIGINT_CONSTEXPR bigint_columns &bigint_columns::add(const bigint &n, bool negate, size_t shift)
+{
+    size_t len = n.digits.size();
+    if (columns.size() < len + shift)
+        columns.resize(len + shift, 0);
+
+    reserve_load(9);
+    int64_t sign = n.get_is_negative() != negate ? -1 : 1;
+    for (uint64_t i = 0; i < len; i++)
+    {
+        columns[shift + i] += sign * n.digits[len - 1 - i];
+    }
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint_columns &bigint_columns::add(int64_t n)
+{
+    if (columns.size() < 20)
+        columns.resize(20, 0);
+
+    reserve_load(9);
+    int64_t sign = n < 0 ? -1 : 1;
+    uint64_t magnitude = n < 0 ? uint64_t(0) - static_cast<uint64_t>(n) : static_cast<uint64_t>(n);
+    for (uint64_t i = 0; magnitude; i++)
+    {
+        columns[i] += sign * static_cast<int64_t>(magnitude % 10);
+        magnitude /= 10;
+    }
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint_columns &bigint_columns::add(const bigint_columns &other)
+{
+    if (columns.size() < other.columns.size())
+        columns.resize(other.columns.size(), 0);
+
+    reserve_load(other.load);
+    for (uint64_t i = 0; i < other.columns.size(); i++)
+    {
+        columns[i] += other.columns[i];
+    }
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint_columns &bigint_columns::add_product(const bigint &a, const bigint &b, bool negate)
+{
+    if (a.is_zero() || b.is_zero())
+        return *this;
+
+    size_t a_len = a.digits.size();
+    size_t b_len = b.digits.size();
+    if (std::min(a_len, b_len) >= BIGINT_MUL_KARATSUBA_THRESHOLD)
+        return add(bigint::multiply(a, b), negate);
+    if (columns.size() < a_len + b_len)
+        columns.resize(a_len + b_len, 0);
+
+    reserve_load(81 * std::min(a_len, b_len));
+    int64_t sign = (a.get_is_negative() != b.get_is_negative()) != negate ? -1 : 1;
+    for (uint64_t i = 0; i < b_len; i++)
+    {
+        int64_t factor = sign * b.digits[b_len - 1 - i];
+        if (factor == 0)
+            continue;
+        for (uint64_t j = 0; j < a_len; j++)
+        {
+            columns[i + j] += factor * a.digits[a_len - 1 - j];
+        }
+    }
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint_columns &bigint_columns::add_square(const bigint &a, bool negate)
+{
+    if (a.is_zero())
+        return *this;
+
+    size_t len = a.digits.size();
+    if (columns.size() < 2 * len)
+        columns.resize(2 * len, 0);
+
+    reserve_load(81 * len);
+    int64_t sign = negate ? -1 : 1;
+    for (uint64_t i = 0; i < len; i++)
+    {
+        int64_t digit = a.digits[len - 1 - i];
+        if (digit == 0)
+            continue;
+        columns[2 * i] += sign * digit * digit;
+        int64_t twice = 2 * sign * digit;
+        for (uint64_t j = i + 1; j < len; j++)
+        {
+            columns[i + j] += twice * a.digits[len - 1 - j];
+        }
+    }
+    return *this;
+}
+
+BIGINT_CONSTEXPR bool bigint_columns::propagate(std::vector<int64_t> &work)
+{
+    int64_t carry = 0;
+    for (uint64_t i = 0; i < work.size(); i++)
+    {
+        int64_t value = work[i] + carry;
+        int64_t digit = value % 10;
+        carry = value / 10;
+        if (digit < 0)
+        {
+            digit += 10;
+            carry -= 1;
+        }
+        work[i] = digit;
+    }
+    if (carry < 0)
+    {
+        work.push_back(carry);
+        return false;
+    }
+    while (carry > 0)
+    {
+        work.push_back(carry % 10);
+        carry /= 10;
+    }
+    return true;
+}
+
+BIGINT_CONSTEXPR bigint bigint_columns::to_bigint() const
+{
+    std::vector<int64_t> work(columns);
+    bool negative = !propagate(work);
+    if (negative)
+    {
+        for (int64_t &column : work)
+        {
+            column = -column;
+        }
+        propagate(work);
+    }
+
+    while (!work.empty() && work.back() == 0)
+    {
+        work.pop_back();
+    }
+
+    bigint result;
+    if (work.empty())
+        return result;
+
+    BIGINT_RECORD_BYTES(0, work.size());
+    result.digits.resize(work.size());
+    for (uint64_t i = 0; i < work.size(); i++)
+    {
+        result.digits[work.size() - 1 - i] = static_cast<uint8_t>(work[i]);
+    }
+    result.set_negative(negative);
+    return result;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::add_in_place(const bigint &term, bool negate)
+{
+    size_t term_len = term.size();
+    if (term_len == 0)
+        return *this;
+    size_t term_end = term.digits.size();
+    bool term_negative = term.get_is_negative() != negate;
+
+    size_t len = size();
+    if (len == 0)
+    {
+        digits.assign(term.digits.begin() + static_cast<std::ptrdiff_t>(term_end - term_len), term.digits.end());
+        is_negative = term_negative;
+        return *this;
+    }
+
+    // leading zeros of the buffer are free room; digit i from the right is digits[room - 1 - i]
+    bool magnitude_add = term_negative == get_is_negative();
+    bool term_larger = false;
+    if (!magnitude_add)
+    {
+        size_t lead = digits.size() - len;
+        term_larger = term_len > len ||
+                      (term_len == len && std::lexicographical_compare(digits.begin() + static_cast<std::ptrdiff_t>(lead), digits.end(),
+                                                                       term.digits.begin() + static_cast<std::ptrdiff_t>(term_end - term_len), term.digits.end()));
+    }
+    size_t needed = magnitude_add ? term_len + 1 : term_len;
+    if (digits.size() < needed)
+        digits.insert(digits.begin(), needed - digits.size(), uint8_t(0));
+    size_t room = digits.size();
+
+    int carry = 0;
+    if (magnitude_add)
+    {
+        for (uint64_t i = 0; i < room && (i < term_len || carry); i++)
+        {
+            int value = digits[room - 1 - i] + carry + (i < term_len ? term.digits[term_end - 1 - i] : 0);
+            carry = value >= 10;
+            digits[room - 1 - i] = static_cast<uint8_t>(carry ? value - 10 : value);
+        }
+        if (carry)
+            digits.insert(digits.begin(), uint8_t(1));
+    }
+    else if (!term_larger)
+    {
+        // |*this| - |term|; the borrow stops at the first nonzero digit above term
+        for (uint64_t i = 0; i < room && (i < term_len || carry); i++)
+        {
+            int value = digits[room - 1 - i] - carry - (i < term_len ? term.digits[term_end - 1 - i] : 0);
+            carry = value < 0;
+            digits[room - 1 - i] = static_cast<uint8_t>(carry ? value + 10 : value);
+        }
+    }
+    else
+    {
+        // |term| - |*this|, which only has digits where term has them
+        for (uint64_t i = 0; i < term_len; i++)
+        {
+            int value = term.digits[term_end - 1 - i] - digits[room - 1 - i] - carry;
+            carry = value < 0;
+            digits[room - 1 - i] = static_cast<uint8_t>(carry ? value + 10 : value);
+        }
+        is_negative = term_negative;
+    }
+
+    // drop the leading zeros, keeping at least one digit
+    size_t zeros = 0;
+    while (zeros + 1 < digits.size() && digits[zeros] == 0)
+    {
+        ++zeros;
+    }
+    if (zeros > 0)
+    {
+        std::copy(digits.begin() + static_cast<std::ptrdiff_t>(zeros), digits.end(), digits.begin());
+        digits.resize(digits.size() - zeros);
+    }
+    if (digits.size() == 1 && digits[0] == 0)
         is_negative = false;
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint &bigint::addmul(bigint const &x, bigint const &y)
+{
+    return add_in_place(multiply(x, y), false);
+}
+
+BIGINT_CONSTEXPR bigint &bigint::submul(bigint const &x, bigint const &y)
+{
+    return add_in_place(multiply(x, y), true);
+}
+
+BIGINT_CONSTEXPR bigint &fma(bigint &acc, bigint const &x, bigint const &y)
+{
+    return acc.addmul(x, y);
+}
+
+bigint_accumulator::bigint_accumulator() : columns(20), pending(0) {}
+
+bigint_accumulator &bigint_accumulator::operator+=(int64_t n)
+{
+    if ((n > 0 && pending > std::numeric_limits<int64_t>::max() - n) ||
+        (n < 0 && pending < std::numeric_limits<int64_t>::min() - n))
+    {
+        columns.add(pending);
+        pending = 0;
+    }
+    pending += n;
+    return *this;
+}
+
+bigint_accumulator &bigint_accumulator::operator-=(int64_t n)
+{
+    if (n == std::numeric_limits<int64_t>::min())
+    {
+        *this += std::numeric_limits<int64_t>::max();
+        return *this += 1;
+    }
+    return *this += -n;
+}
+
+bigint_accumulator &bigint_accumulator::operator+=(bigint const &n)
+{
+    columns.add(n);
+    return *this;
+}
+
+bigint_accumulator &bigint_accumulator::operator-=(bigint const &n)
+{
+    columns.add(n, true);
+    return *this;
+}
+
+bigint_accumulator &bigint_accumulator::operator+=(bigint_accumulator const &other)
+{
+    columns.add(other.columns);
+    return *this += other.pending;
+}
+
+bigint bigint_accumulator::to_bigint() const
+{
+    bigint_columns total(columns);
+    total.add(pending);
+    return total.to_bigint();
+}
+
+BIGINT_CONSTEXPR bigint bigint::slice(size_t shift, size_t count) const
+{
+    bigint part;
+    size_t len = digits.size();
+    if (shift >= len)
+        return part;
+
+    size_t last = len - shift;
+    size_t first = count >= last ? 0 : last - count;
+    while (first < last && digits[first] == 0)
+    {
+        ++first;
+    }
+    if (first < last)
+        part.digits.assign(digits.begin() + static_cast<std::ptrdiff_t>(first), digits.begin() + static_cast<std::ptrdiff_t>(last));
+    return part;
+}
+
+BIGINT_CONSTEXPR bigint bigint::multiply(const bigint &a, const bigint &b)
+{
+    if (a.is_zero() || b.is_zero())
+        return bigint();
+
+    size_t a_len = a.digits.size();
+    size_t b_len = b.digits.size();
+    if (a_len < b_len)
+        return multiply(b, a);
+    if (b_len < BIGINT_MUL_KARATSUBA_THRESHOLD)
+    {
+        BIGINT_RECORD(mul_schoolbook, a_len);
+        return bigint_columns(a_len + b_len).add_product(a, b).to_bigint();
+    }
+
+    bigint_columns result(a_len + b_len + 1);
+    if (a_len >= 2 * b_len)
+    {
+        // cut the longer operand into pieces as long as the shorter one
+        bigint b_abs = b.slice(0, b_len);
+        for (size_t shift = 0; shift < a_len; shift += b_len)
+        {
+            result.add(multiply(a.slice(shift, b_len), b_abs), false, shift);
+        }
+    }
+    else
+    {
+        BIGINT_RECORD(mul_karatsuba, a_len);
+        // (a1 * 10^half + a0)(b1 * 10^half + b0) = a1 b1 * 10^(2 half) + ((a0 + a1)(b0 + b1) - a1 b1 - a0 b0) * 10^half + a0 b0
+        size_t half = a_len / 2;
+        bigint a_low = a.slice(0, half);
+        bigint a_high = a.slice(half, a_len - half);
+        bigint b_low = b.slice(0, half);
+        bigint b_high = b.slice(half, b_len - half);
+        bigint low = multiply(a_low, b_low);
+        bigint high = multiply(a_high, b_high);
+        bigint mid = multiply(bigint_columns(a_len - half + 1).add(a_low).add(a_high).to_bigint(),
+                              bigint_columns(a_len - half + 1).add(b_low).add(b_high).to_bigint());
+
+        result.add(low);
+        result.add(high, false, 2 * half);
+        result.add(mid, false, half);
+        result.add(high, true, half);
+        result.add(low, true, half);
+    }
+    bigint prod = result.to_bigint();
+    prod.set_negative(a.get_is_negative() != b.get_is_negative());
+    return prod;
+}
+
+BIGINT_CONSTEXPR bigint bigint::square() const
+{
+    size_t len = digits.size();
+    BIGINT_SPAN(square, len);
+    if (len < BIGINT_SQR_KARATSUBA_THRESHOLD)
+    {
+        BIGINT_RECORD(sqr_schoolbook, len);
+        return bigint_columns(2 * len).add_square(*this).to_bigint();
+    }
+    BIGINT_RECORD(sqr_karatsuba, len);
+
+    // (high * 10^half + low)^2 = high^2 * 10^(2 half) + ((high + low)^2 - high^2 - low^2) * 10^half + low^2
+    size_t half = len / 2;
+    bigint low = slice(0, half);
+    bigint high = slice(half, len - half);
+    bigint low_sq = low.square();
+    bigint high_sq = high.square();
+    bigint mid_sq = bigint_columns(len - half + 1).add(low).add(high).to_bigint().square();
+
+    bigint_columns result(2 * len + 1);
+    result.add(low_sq);
+    result.add(high_sq, false, 2 * half);
+    result.add(mid_sq, false, half);
+    result.add(high_sq, true, half);
+    result.add(low_sq, true, half);
+    return result.to_bigint();
+}
+
+BIGINT_CONSTEXPR bigint pow(const bigint &base, uint64_t exponent)
+{
+    BIGINT_SPAN(pow, base.digits.size());
+    if (exponent == 0)
+        return bigint(1);
+    if (base.is_zero())
+        return bigint();
+
+    // base = reduced * 10^zeros; the zeros of the power are appended at the end
+    size_t len = base.digits.size();
+    size_t zeros = 0;
+    while (base.digits[len - 1 - zeros] == 0)
+    {
+        ++zeros;
+    }
+    bigint reduced = base.slice(zeros, len - zeros);
+
+    bigint result(1);
+    if (reduced != bigint(1))
+    {
+        int64_t bits = 0;
+        while (bits < 64 && (exponent >> bits))
+        {
+            ++bits;
+        }
+        // the table holds the odd powers reduced^1, reduced^3, ..., reduced^(2^window - 1)
+        int64_t window = bits <= 8 ? 1 : bits <= 24 ? 3 : bits <= 48 ? 4 : 5;
+        std::vector<bigint> odd_powers(size_t(1) << (window - 1));
+        odd_powers[0] = reduced;
+        if (window > 1)
+        {
+            bigint reduced_sq = reduced.square();
+            for (uint64_t i = 1; i < odd_powers.size(); i++)
+            {
+                odd_powers[i] = bigint::multiply(odd_powers[i - 1], reduced_sq);
+            }
+        }
+
+        int64_t bit = bits - 1;
+        while (bit >= 0)
+        {
+            if (!((exponent >> bit) & 1))
+            {
+                result = result.square();
+                --bit;
+                continue;
+            }
+            // longest window of at most `window` bits that starts at `bit` and ends in a set bit
+            int64_t low_bit = std::max<int64_t>(bit - window + 1, 0);
+            while (!((exponent >> low_bit) & 1))
+            {
+                ++low_bit;
+            }
+            uint64_t value = (exponent >> low_bit) & ((uint64_t(1) << (bit - low_bit + 1)) - 1);
+            for (int64_t i = low_bit; i <= bit; i++)
+            {
+                result = result.square();
+            }
+            result = bigint::multiply(result, odd_powers[value >> 1]);
+            bit = low_bit - 1;
+        }
+    }
+
+    for (uint64_t i = 0; i < zeros * exponent; i++)
+    {
+        result.push_back(uint8_t(0));
+    }
+    result.set_negative(base.get_is_negative() && (exponent & 1));
+    return result;
+}
+
+std::vector<uint32_t> bigint::to_words() const
+{
+    // group the digits into base 10^9 chunks, most significant chunk first
+    std::vector<uint32_t> chunks;
+    size_t len = digits.size();
+    size_t head = len % 9 ? len % 9 : 9;
+    uint32_t chunk = 0;
+    for (uint64_t i = 0; i < len; i++)
+    {
+        chunk = chunk * 10 + digits[i];
+        if (i + 1 == head || (i + 1 > head && (i + 1 - head) % 9 == 0))
+        {
+            if (chunk || !chunks.empty())
+                chunks.push_back(chunk);
+            chunk = 0;
+        }
+    }
+
+    // repeatedly divide the chunks by 2^32, collecting the remainders as words
+    std::vector<uint32_t> words;
+    while (!chunks.empty())
+    {
+        uint64_t remainder = 0;
+        for (uint32_t &part : chunks)
+        {
+            uint64_t value = remainder * 1000000000 + part;
+            part = static_cast<uint32_t>(value >> 32);
+            remainder = value & 0xffffffffu;
+        }
+        words.push_back(static_cast<uint32_t>(remainder));
+        chunks.erase(chunks.begin(), std::find_if(chunks.begin(), chunks.end(), [](uint32_t part)
+                                                  { return part != 0; }));
+    }
+    return words;
+}
+
+BIGINT_CONSTEXPR void bigint::divmod_abs(const bigint &a, const bigint &b, bigint &quotient, bigint &remainder)
+{
+    // significant digits of the divisor, most significant first
+    auto first = std::find_if(b.digits.begin(), b.digits.end(), [](uint8_t d)
+                              { return d != 0; });
+    std::vector<uint8_t> divisor(first, b.digits.end());
+    size_t m = divisor.size();
+    uint64_t divisor_top = 0;
+    for (uint64_t i = 0; i < std::min<size_t>(m, 18); i++)
+    {
+        divisor_top = divisor_top * 10 + divisor[i];
+    }
+
+    std::vector<uint8_t> q;
+    std::vector<uint8_t> r; // running remainder, most significant first, no leading zeros
+    for (uint8_t digit : a.digits)
+    {
+        if (!r.empty() || digit != 0)
+            r.push_back(digit);
+
+        uint8_t q_digit = 0;
+        bool fits = r.size() > m || (r.size() == m && !std::lexicographical_compare(r.begin(), r.end(), divisor.begin(), divisor.end()));
+        if (fits)
+        {
+            // r has m or m + 1 digits; compare the same number of leading digits of both
+            size_t extra = r.size() - m;
+            size_t top_len = std::min<size_t>(m, 18 - extra);
+            uint64_t r_top = 0;
+            for (uint64_t i = 0; i < top_len + extra; i++)
+            {
+                r_top = r_top * 10 + r[i];
+            }
+            uint64_t b_top = divisor_top;
+            for (uint64_t i = top_len; i < std::min<size_t>(m, 18); i++)
+            {
+                b_top /= 10;
+            }
+            uint64_t estimate = std::min<uint64_t>(r_top / b_top, 9);
+
+            // r -= estimate * divisor, adding the divisor back while the result is negative
+            int64_t borrow = 0;
+            for (uint64_t i = 0; i < r.size(); i++)
+            {
+                int64_t value = int64_t(r[r.size() - 1 - i]) - borrow - (i < m ? int64_t(estimate) * divisor[m - 1 - i] : 0);
+                borrow = 0;
+                if (value < 0)
+                {
+                    borrow = (-value + 9) / 10;
+                    value += borrow * 10;
+                }
+                r[r.size() - 1 - i] = static_cast<uint8_t>(value);
+            }
+            while (borrow > 0)
+            {
+                --estimate;
+                int64_t carry = 0;
+                for (uint64_t i = 0; i < r.size(); i++)
+                {
+                    int64_t value = int64_t(r[r.size() - 1 - i]) + carry + (i < m ? divisor[m - 1 - i] : 0);
+                    carry = value / 10;
+                    r[r.size() - 1 - i] = static_cast<uint8_t>(value % 10);
+                }
+                borrow -= carry;
+            }
+            q_digit = static_cast<uint8_t>(estimate);
+            r.erase(r.begin(), std::find_if(r.begin(), r.end(), [](uint8_t d)
+                                            { return d != 0; }));
+        }
+        if (!q.empty() || q_digit != 0)
+            q.push_back(q_digit);
+    }
+
+    quotient = bigint();
+    remainder = bigint();
+    if (!q.empty())
+        quotient.digits = q;
+    if (!r.empty())
+        remainder.digits = r;
+}
+
+modular_context::modular_context(const bigint &n) : modulus(n), reducer(n.is_zero() ? bigint(1) : n)
+{
+    if (n.get_is_negative() || n.is_zero())
+    {
+        throw std::invalid_argument("modular_context::modular_context : Modulus must be positive.");
+    }
+    uint8_t last = n.digits.back();
+    if (last % 2 == 0 || last == 5)
+    {
+        throw std::invalid_argument("modular_context::modular_context : Modulus must be coprime to 10.");
+    }
+
+    width = (n.size() + limb_digits - 1) / limb_digits;
+    pack(n, modulus_limbs);
+
+    // N * N^-1 = 1 (mod 10) for the last digits 1, 3, 7, 9, then lifted to mod 10^6 by Newton steps
+    const int64_t inverses[10] = {0, 1, 0, 7, 0, 0, 0, 3, 0, 9};
+    int64_t n0 = modulus_limbs[0];
+    int64_t x = inverses[last];
+    for (int i = 0; i < 3; i++)
+    {
+        int64_t nx = n0 * x % limb_base;
+        x = x * ((2 - nx + limb_base) % limb_base) % limb_base;
+    }
+    inverse = (limb_base - x) % limb_base;
+
+    load(pow(bigint(10), limb_digits * width), one);
+    load(pow(bigint(10), 2 * limb_digits * width), r_squared);
+}
+
+const bigint &modular_context::get_modulus() const
+{
+    return modulus;
+}
+
+void modular_context::load(const bigint &n, std::vector<int64_t> &out) const
+{
+    bigint remainder = reducer.mod(n.abs());
+    if (n.get_is_negative() && !remainder.is_zero())
+    {
+        remainder = modulus - remainder;
+    }
+    pack(remainder, out);
+}
+
+void modular_context::pack(const bigint &n, std::vector<int64_t> &out) const
+{
+    out.assign(width, 0);
+    size_t len = n.digits.size();
+    int64_t scale = 1;
+    for (uint64_t i = 0; i < len && i < width * limb_digits; i++)
+    {
+        scale = i % limb_digits == 0 ? 1 : scale * 10;
+        out[i / limb_digits] += scale * n.digits[len - 1 - i];
+    }
+}
+
+bigint modular_context::store(const std::vector<int64_t> &in)
+{
+    std::vector<uint8_t> digits;
+    for (int64_t limb : in)
+    {
+        for (uint64_t i = 0; i < limb_digits; i++)
+        {
+            digits.push_back(static_cast<uint8_t>(limb % 10));
+            limb /= 10;
+        }
+    }
+    while (!digits.empty() && digits.back() == 0)
+    {
+        digits.pop_back();
+    }
+
+    bigint result;
+    if (!digits.empty())
+        result.digits.assign(digits.rbegin(), digits.rend());
+    return result;
+}
+
+void modular_context::redc(const std::vector<int64_t> &a, const std::vector<int64_t> &b, std::vector<int64_t> &out) const
+{
+    scratch.assign(2 * width + 2, 0);
+    if (&a == &b)
+    {
+        for (uint64_t i = 0; i < width; i++)
+        {
+            scratch[2 * i] += a[i] * a[i];
+            int64_t twice = 2 * a[i];
+            for (uint64_t j = i + 1; j < width; j++)
+            {
+                scratch[i + j] += twice * a[j];
+            }
+        }
+    }
+    else
+    {
+        for (uint64_t i = 0; i < width; i++)
+        {
+            int64_t factor = a[i];
+            for (uint64_t j = 0; j < width; j++)
+            {
+                scratch[i + j] += factor * b[j];
+            }
+        }
+    }
+
+    // clear one limb per step by adding a multiple of N, then carry it into the next column
+    for (uint64_t i = 0; i < width; i++)
+    {
+        int64_t m = (scratch[i] % limb_base) * inverse % limb_base;
+        for (uint64_t j = 0; j < width; j++)
+        {
+            scratch[i + j] += m * modulus_limbs[j];
+        }
+        scratch[i + 1] += scratch[i] / limb_base;
+    }
+
+    // the result T / R is below 2N; subtract N once and keep the difference if it did not borrow
+    product.assign(width + 1, 0);
+    int64_t carry = 0;
+    for (uint64_t i = 0; i <= width; i++)
+    {
+        int64_t value = scratch[width + i] + carry;
+        product[i] = value % limb_base;
+        carry = value / limb_base;
+    }
+    reduced.resize(width + 1);
+    int64_t borrow = 0;
+    for (uint64_t i = 0; i <= width; i++)
+    {
+        int64_t value = product[i] - (i < width ? modulus_limbs[i] : 0) - borrow;
+        borrow = value < 0;
+        reduced[i] = value + limb_base * borrow;
+    }
+    int64_t keep = -borrow;
+    out.resize(width);
+    for (uint64_t i = 0; i < width; i++)
+    {
+        out[i] = (product[i] & keep) | (reduced[i] & ~keep);
+    }
+}
+
+bigint modular_context::to_montgomery(const bigint &a) const
+{
+    load(a, operand_a);
+    redc(operand_a, r_squared, operand_a);
+    return store(operand_a);
+}
+
+bigint modular_context::from_montgomery(const bigint &a) const
+{
+    load(a, operand_a);
+    operand_b.assign(width, 0);
+    operand_b[0] = 1;
+    redc(operand_a, operand_b, operand_a);
+    return store(operand_a);
+}
+
+bigint modular_context::mulmod(const bigint &a, const bigint &b) const
+{
+    load(a, operand_a);
+    load(b, operand_b);
+    redc(operand_a, operand_b, operand_a);
+    return store(operand_a);
+}
+
+bigint modular_context::sqrmod(const bigint &a) const
+{
+    load(a, operand_a);
+    redc(operand_a, operand_a, operand_a);
+    return store(operand_a);
+}
+
+bigint modular_context::powmod(const bigint &base, const bigint &exponent, bool constant_time) const
+{
+    if (exponent.get_is_negative() && !exponent.is_zero())
+    {
+        throw std::invalid_argument("modular_context::powmod : Negative exponent.");
+    }
+    std::vector<uint32_t> words = exponent.to_words();
+    int64_t bits = static_cast<int64_t>(words.size() * 32);
+    auto bit_at = [&words](int64_t i)
+    {
+        return (words[static_cast<size_t>(i / 32)] >> (i % 32)) & 1u;
+    };
+    while (bits > 0 && !bit_at(bits - 1))
+    {
+        --bits;
+    }
+
+    std::vector<int64_t> x;
+    load(base, operand_a);
+    redc(operand_a, r_squared, x);
+    std::vector<int64_t> acc = one;
+
+    if (constant_time)
+    {
+        // fixed 4-bit windows; table[e] = x^e in Montgomery form, table[0] = 1
+        const int64_t window = 4;
+        std::vector<std::vector<int64_t>> table(size_t(1) << window);
+        table[0] = one;
+        table[1] = x;
+        for (uint64_t e = 2; e < table.size(); e++)
+        {
+            redc(table[e - 1], x, table[e]);
+        }
+
+        std::vector<int64_t> entry(width);
+        for (int64_t w = (bits + window - 1) / window - 1; w >= 0; w--)
+        {
+            for (int64_t s = 0; s < window; s++)
+            {
+                redc(acc, acc, acc);
+            }
+            uint32_t value = 0;
+            for (int64_t s = window - 1; s >= 0; s--)
+            {
+                int64_t i = w * window + s;
+                value = (value << 1) | (i < static_cast<int64_t>(words.size() * 32) ? bit_at(i) : 0u);
+            }
+            std::fill(entry.begin(), entry.end(), 0);
+            for (uint32_t e = 0; e < table.size(); e++)
+            {
+                int64_t mask = -static_cast<int64_t>(e == value);
+                for (uint64_t j = 0; j < width; j++)
+                {
+                    entry[j] |= table[e][j] & mask;
+                }
+            }
+            redc(acc, entry, acc);
+        }
+    }
+    else
+    {
+        // sliding window; odd_powers[i] = x^(2i + 1) in Montgomery form
+        int64_t window = bits <= 8 ? 1 : bits <= 24 ? 3 : bits <= 96 ? 4 : bits <= 768 ? 5 : 6;
+        std::vector<std::vector<int64_t>> odd_powers(size_t(1) << (window - 1));
+        odd_powers[0] = x;
+        if (window > 1)
+        {
+            std::vector<int64_t> x_sq;
+            redc(x, x, x_sq);
+            for (uint64_t i = 1; i < odd_powers.size(); i++)
+            {
+                redc(odd_powers[i - 1], x_sq, odd_powers[i]);
+            }
+        }
+
+        int64_t bit = bits - 1;
+        while (bit >= 0)
+        {
+            if (!bit_at(bit))
+            {
+                redc(acc, acc, acc);
+                --bit;
+                continue;
+            }
+            int64_t low_bit = std::max<int64_t>(bit - window + 1, 0);
+            while (!bit_at(low_bit))
+            {
+                ++low_bit;
+            }
+            uint32_t value = 0;
+            for (int64_t i = bit; i >= low_bit; i--)
+            {
+                value = (value << 1) | bit_at(i);
+                redc(acc, acc, acc);
+            }
+            redc(acc, odd_powers[value >> 1], acc);
+            bit = low_bit - 1;
+        }
+    }
+
+    operand_b.assign(width, 0);
+    operand_b[0] = 1;
+    redc(acc, operand_b, acc);
+    return store(acc);
+}
+
+bigint_divisor::reciprocal::reciprocal(uint64_t d) : divisor(d), magic(0), shift(0)
+{
+    while ((uint64_t(1) << shift) < d)
+    {
+        ++shift;
+    }
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 numerator = static_cast<unsigned __int128>(1) << (60 + shift);
+    magic = static_cast<uint64_t>((numerator + d - 1) / d);
+#endif
+}
+
+uint64_t bigint_divisor::reciprocal::divide(uint64_t n) const
+{
+#ifdef __SIZEOF_INT128__
+    return static_cast<uint64_t>((static_cast<unsigned __int128>(n) * magic) >> (60 + shift));
+#else
+    return n / divisor;
+#endif
+}
+
+bigint_divisor::bigint_divisor(const bigint &d) : divisor(d), factor(1)
+{
+    if (d.is_zero())
+    {
+        throw std::invalid_argument("bigint_divisor::bigint_divisor : Division by zero.");
+    }
+
+    limbs = pack(d);
+    if (limbs.size() == 1)
+    {
+        top = reciprocal(limbs[0]);
+        return;
+    }
+
+    // scale so the leading limb is at least limb_base / 2; the quotient is unchanged
+    factor = limb_base / (limbs.back() + 1);
+    uint64_t carry = 0;
+    for (uint64_t &limb : limbs)
+    {
+        uint64_t value = limb * factor + carry;
+        limb = value % limb_base;
+        carry = value / limb_base;
+    }
+    top = reciprocal(limbs.back());
+}
+
+const bigint &bigint_divisor::get_divisor() const
+{
+    return divisor;
+}
+
+std::vector<uint64_t> bigint_divisor::pack(const bigint &n)
+{
+    std::vector<uint64_t> out;
+    size_t len = n.digits.size();
+    uint64_t limb = 0;
+    uint64_t scale = 1;
+    for (uint64_t i = 0; i < len; i++)
+    {
+        limb += scale * n.digits[len - 1 - i];
+        scale *= 10;
+        if (scale == limb_base || i + 1 == len)
+        {
+            out.push_back(limb);
+            limb = 0;
+            scale = 1;
+        }
+    }
+    while (!out.empty() && out.back() == 0)
+    {
+        out.pop_back();
+    }
+    return out;
+}
+
+bigint bigint_divisor::unpack(const std::vector<uint64_t> &in, bool negative)
+{
+    std::vector<uint8_t> digits;
+    digits.reserve(in.size() * limb_digits);
+    for (uint64_t limb : in)
+    {
+        for (uint64_t i = 0; i < limb_digits; i++)
+        {
+            digits.push_back(static_cast<uint8_t>(limb % 10));
+            limb /= 10;
+        }
+    }
+    while (!digits.empty() && digits.back() == 0)
+    {
+        digits.pop_back();
+    }
+
+    bigint result;
+    if (!digits.empty())
+    {
+        BIGINT_RECORD_BYTES(0, digits.size());
+        result.digits.assign(digits.rbegin(), digits.rend());
+        result.set_negative(negative);
+    }
+    return result;
+}
+
+void bigint_divisor::run(const bigint &a, std::vector<uint64_t> *quotient, std::vector<uint64_t> &remainder) const
+{
+    BIGINT_SPAN(div, bigint_columns::width(a));
+    std::vector<uint64_t> u = pack(a);
+    size_t n = limbs.size();
+
+    if (n == 1)
+    {
+        // nine digits per step: r * 10^9 + limb stays below d * 10^9 < 2^60
+        uint64_t d = limbs[0];
+        uint64_t r = 0;
+        if (quotient)
+            quotient->assign(u.size(), 0);
+        for (uint64_t i = u.size(); i-- > 0;)
+        {
+            uint64_t value = r * limb_base + u[i];
+            uint64_t q = top.divide(value);
+            r = value - q * d;
+            if (quotient)
+                (*quotient)[i] = q;
+        }
+        remainder.assign(1, r);
+        return;
+    }
+
+    if (u.size() < n)
+    {
+        if (quotient)
+            quotient->clear();
+        remainder = u;
+        return;
+    }
+
+    // normalise the dividend with the same factor, with one extra leading limb
+    uint64_t carry = 0;
+    for (uint64_t &limb : u)
+    {
+        uint64_t value = limb * factor + carry;
+        limb = value % limb_base;
+        carry = value / limb_base;
+    }
+    u.push_back(carry);
+
+    size_t m = u.size() - n - 1;
+    if (quotient)
+        quotient->assign(m + 1, 0);
+    uint64_t v_top = limbs[n - 1];
+    uint64_t v_next = limbs[n - 2];
+    for (uint64_t j = m + 1; j-- > 0;)
+    {
+        // estimate from the two leading limbs, refined with the third
+        uint64_t numerator = u[j + n] * limb_base + u[j + n - 1];
+        uint64_t q_hat = top.divide(numerator);
+        uint64_t r_hat = numerator - q_hat * v_top;
+        while (q_hat >= limb_base || q_hat * v_next > r_hat * limb_base + u[j + n - 2])
+        {
+            --q_hat;
+            r_hat += v_top;
+            if (r_hat >= limb_base)
+                break;
+        }
+
+        // u[j .. j + n] -= q_hat * v
+        uint64_t product_carry = 0;
+        int64_t borrow = 0;
+        for (uint64_t i = 0; i < n; i++)
+        {
+            uint64_t product = q_hat * limbs[i] + product_carry;
+            product_carry = product / limb_base;
+            int64_t value = static_cast<int64_t>(u[i + j]) - static_cast<int64_t>(product % limb_base) - borrow;
+            borrow = value < 0;
+            u[i + j] = static_cast<uint64_t>(value + borrow * static_cast<int64_t>(limb_base));
+        }
+        int64_t value = static_cast<int64_t>(u[j + n]) - static_cast<int64_t>(product_carry) - borrow;
+        borrow = value < 0;
+        u[j + n] = static_cast<uint64_t>(value + borrow * static_cast<int64_t>(limb_base));
+
+        if (borrow)
+        {
+            // the estimate was one too large: add the divisor back
+            --q_hat;
+            uint64_t add_carry = 0;
+            for (uint64_t i = 0; i < n; i++)
+            {
+                uint64_t sum = u[i + j] + limbs[i] + add_carry;
+                add_carry = sum / limb_base;
+                u[i + j] = sum % limb_base;
+            }
+            u[j + n] = (u[j + n] + add_carry) % limb_base;
+        }
+        if (quotient)
+            (*quotient)[j] = q_hat;
+    }
+
+    // undo the normalisation of the remainder
+    remainder.assign(n, 0);
+    uint64_t r = 0;
+    for (uint64_t i = n; i-- > 0;)
+    {
+        uint64_t value = r * limb_base + u[i];
+        remainder[i] = value / factor;
+        r = value % factor;
+    }
+}
+
+bigint bigint_divisor::div(const bigint &a) const
+{
+    std::vector<uint64_t> quotient;
+    std::vector<uint64_t> remainder;
+    run(a, &quotient, remainder);
+    return unpack(quotient, a.get_is_negative() != divisor.get_is_negative());
+}
+
+bigint bigint_divisor::mod(const bigint &a) const
+{
+    std::vector<uint64_t> remainder;
+    run(a, nullptr, remainder);
+    return unpack(remainder, a.get_is_negative());
+}
+
+std::pair<bigint, bigint> bigint_divisor::divmod(const bigint &a) const
+{
+    std::vector<uint64_t> quotient;
+    std::vector<uint64_t> remainder;
+    run(a, &quotient, remainder);
+    return std::make_pair(unpack(quotient, a.get_is_negative() != divisor.get_is_negative()), unpack(remainder, a.get_is_negative()));
+}
+
+uint8_t bigint_divisor::last_digit(const bigint &n)
+{
+    return n.digits.empty() ? 0 : n.digits.back();
+}
+
+bool divisible_by(const bigint &a, const bigint_divisor &d)
+{
+    if (d.limbs.size() == 1 && (d.limbs[0] == 1 || d.limbs[0] == 2 || d.limbs[0] == 5 || d.limbs[0] == 10))
+    {
+        return bigint_divisor::last_digit(a) % d.limbs[0] == 0;
+    }
+
+    std::vector<uint64_t> remainder;
+    d.run(a, nullptr, remainder);
+    return std::all_of(remainder.begin(), remainder.end(), [](uint64_t limb)
+                       { return limb == 0; });
+}
+
+std::vector<uint64_t> bigint_divisor::combine(int64_t a, const std::vector<uint64_t> &x, int64_t b, const std::vector<uint64_t> &y)
+{
+    // |a * x_i| + |b * y_i| < 2^31 * 10^9 * 2, so every column fits in int64_t with its carry
+    std::vector<uint64_t> out(std::max(x.size(), y.size()) + 2, 0);
+    const int64_t base = static_cast<int64_t>(limb_base);
+    int64_t carry = 0;
+    for (size_t i = 0; i < out.size(); i++)
+    {
+        int64_t value = carry;
+        if (i < x.size())
+            value += a * static_cast<int64_t>(x[i]);
+        if (i < y.size())
+            value += b * static_cast<int64_t>(y[i]);
+        int64_t limb = value % base;
+        if (limb < 0)
+            limb += base;
+        carry = (value - limb) / base;
+        out[i] = static_cast<uint64_t>(limb);
+    }
+    while (!out.empty() && out.back() == 0)
+    {
+        out.pop_back();
+    }
+    return out;
+}
+
+bigint bigint_divisor::lehmer(const bigint &a, const bigint &b, bigint *s, bigint *t)
+{
+    const int64_t bound = int64_t(1) << 31;
+    std::vector<uint64_t> x = pack(a);
+    std::vector<uint64_t> y = pack(b);
+    // magnitudes of the cofactors of x and y: x == s0 * |a| + t0 * |b| and y == s1 * |a| + t1 * |b|
+    std::vector<uint64_t> s0(1, 1);
+    std::vector<uint64_t> s1;
+    std::vector<uint64_t> t0;
+    std::vector<uint64_t> t1(1, 1);
+    bool odd = false; // s0 is negative and t0 positive after an odd number of steps
+    bool cofactors = s != nullptr || t != nullptr;
+
+    while (!y.empty())
+    {
+        if (!cofactors && x.size() <= 2)
+        {
+            // both fit in a word: binary GCD
+            uint64_t u = x[0] + (x.size() > 1 ? x[1] * limb_base : 0);
+            uint64_t v = y[0] + (y.size() > 1 ? y[1] * limb_base : 0);
+            int shift = 0;
+            while (((u | v) & 1) == 0)
+            {
+                u >>= 1;
+                v >>= 1;
+                ++shift;
+            }
+            while ((u & 1) == 0)
+                u >>= 1;
+            while (v != 0)
+            {
+                while ((v & 1) == 0)
+                    v >>= 1;
+                if (u > v)
+                    std::swap(u, v);
+                v -= u;
+            }
+            u <<= shift;
+            x.assign(1, u % limb_base);
+            if (u >= limb_base)
+                x.push_back(u / limb_base);
+            break;
+        }
+
+        // leading two limbs of x and the limbs of y at the same positions
+        size_t n = x.size();
+        uint64_t x_top = x[n - 1];
+        uint64_t y_top = n - 1 < y.size() ? y[n - 1] : 0;
+        if (n >= 2)
+        {
+            x_top = x_top * limb_base + x[n - 2];
+            y_top = y_top * limb_base + (n - 2 < y.size() ? y[n - 2] : 0);
+        }
+
+        int64_t x_hat = static_cast<int64_t>(x_top);
+        int64_t y_hat = static_cast<int64_t>(y_top);
+        int64_t A = 1, B = 0, C = 0, D = 1;
+        bool flip = false;
+        while (y_hat + C > 0 && y_hat + D > 0)
+        {
+            int64_t q = (x_hat + A) / (y_hat + C);
+            if (q != (x_hat + B) / (y_hat + D))
+                break;
+            if ((C != 0 && q > bound / std::abs(C)) || (D != 0 && q > bound / std::abs(D)))
+                break;
+            int64_t next_C = A - q * C;
+            int64_t next_D = B - q * D;
+            if (std::abs(next_C) > bound || std::abs(next_D) > bound)
+                break;
+            A = C;
+            B = D;
+            C = next_C;
+            D = next_D;
+            int64_t next_y = x_hat - q * y_hat;
+            x_hat = y_hat;
+            y_hat = next_y;
+            flip = !flip;
+        }
+
+        if (B == 0)
+        {
+            // no quotient could be certified from the leading limbs: one full division step
+            bigint_divisor divisor(unpack(y, false));
+            std::vector<uint64_t> quotient;
+            std::vector<uint64_t> remainder;
+            divisor.run(unpack(x, false), &quotient, remainder);
+            while (!remainder.empty() && remainder.back() == 0)
+            {
+                remainder.pop_back();
+            }
+            x.swap(y);
+            y.swap(remainder);
+            if (cofactors)
+            {
+                while (!quotient.empty() && quotient.back() == 0)
+                {
+                    quotient.pop_back();
+                }
+                std::vector<uint64_t> next_s;
+                std::vector<uint64_t> next_t;
+                if (quotient.size() == 1)
+                {
+                    int64_t q = static_cast<int64_t>(quotient[0]);
+                    next_s = combine(1, s0, q, s1);
+                    next_t = combine(1, t0, q, t1);
+                }
+                else
+                {
+                    bigint q = unpack(quotient, false);
+                    next_s = pack(unpack(s0, false) + unpack(s1, false) * q);
+                    next_t = pack(unpack(t0, false) + unpack(t1, false) * q);
+                }
+                s0.swap(s1);
+                s1.swap(next_s);
+                t0.swap(t1);
+                t1.swap(next_t);
+            }
+            odd = !odd;
+            continue;
+        }
+
+        std::vector<uint64_t> next_x = combine(A, x, B, y);
+        std::vector<uint64_t> next_y = combine(C, x, D, y);
+        x.swap(next_x);
+        y.swap(next_y);
+        if (cofactors)
+        {
+            std::vector<uint64_t> next_s0 = combine(std::abs(A), s0, std::abs(B), s1);
+            std::vector<uint64_t> next_s1 = combine(std::abs(C), s0, std::abs(D), s1);
+            std::vector<uint64_t> next_t0 = combine(std::abs(A), t0, std::abs(B), t1);
+            std::vector<uint64_t> next_t1 = combine(std::abs(C), t0, std::abs(D), t1);
+            s0.swap(next_s0);
+            s1.swap(next_s1);
+            t0.swap(next_t0);
+            t1.swap(next_t1);
+        }
+        if (flip)
+            odd = !odd;
+    }
+
+    if (s)
+        *s = unpack(s0, odd);
+    if (t)
+        *t = unpack(t0, !odd);
+    return unpack(x, false);
+}
+
+bigint gcd(const bigint &a, const bigint &b)
+{
+    BIGINT_SPAN(gcd, std::max(bigint_columns::width(a), bigint_columns::width(b)));
+    if (a.abs() < b.abs())
+        return bigint_divisor::lehmer(b, a, nullptr, nullptr);
+    return bigint_divisor::lehmer(a, b, nullptr, nullptr);
+}
+
+bigint lcm(const bigint &a, const bigint &b)
+{
+    if (a == bigint(0) || b == bigint(0))
+        return bigint(0);
+    return bigint_divisor(gcd(a, b)).div(a.abs()) * b.abs();
+}
+
+std::tuple<bigint, bigint, bigint> gcdext(const bigint &a, const bigint &b)
+{
+    BIGINT_SPAN(gcd, std::max(bigint_columns::width(a), bigint_columns::width(b)));
+    bool swapped = a.abs() < b.abs();
+    const bigint &large = swapped ? b : a;
+    const bigint &small = swapped ? a : b;
+
+    bigint s;
+    bigint t;
+    bigint g = bigint_divisor::lehmer(large, small, &s, &t);
+
+    if (large.get_is_negative())
+        s = -s;
+    if (small.get_is_negative())
+        t = -t;
+    if (swapped)
+        return std::make_tuple(g, t, s);
+    return std::make_tuple(g, s, t);
+}
+
+bigint invmod(const bigint &a, const bigint &n)
+{
+    if (n <= bigint(0))
+    {
+        throw std::invalid_argument("bigint::invmod : Modulus must be positive.");
+    }
+
+    bigint_divisor modulus(n);
+    bigint reduced = modulus.mod(a);
+    if (reduced.get_is_negative())
+        reduced = reduced + n;
+
+    std::tuple<bigint, bigint, bigint> result = gcdext(reduced, n);
+    if (std::get<0>(result) != bigint(1))
+    {
+        throw std::invalid_argument("bigint::invmod : Argument is not invertible.");
+    }
+    bigint inverse = modulus.mod(std::get<1>(result));
+    if (inverse.get_is_negative())
+        inverse = inverse + n;
+    return inverse;
+}
+
+uint64_t bigint::mod_word(uint64_t m) const
+{
+    uint64_t r = 0;
+    for (uint8_t digit : digits)
+    {
+        r = (r * 10 + digit) % m;
+    }
+    return r;
+}
+
+uint64_t bigint::root_word(uint64_t n, uint64_t k)
+{
+    if (k == 1 || n <= 1)
+        return n;
+
+    // x^k <= n, without overflowing
+    auto fits = [n, k](uint64_t x)
+    {
+        uint64_t power = 1;
+        for (uint64_t i = 0; i < k; i++)
+        {
+            if (x != 0 && power > n / x)
+                return false;
+            power *= x;
+        }
+        return true;
+    };
+
+    uint64_t x = static_cast<uint64_t>(std::pow(static_cast<long double>(n), 1.0L / static_cast<long double>(k)));
+    while (x > 0 && !fits(x))
+    {
+        --x;
+    }
+    while (fits(x + 1))
+    {
+        ++x;
+    }
+    return x;
+}
+
+bigint bigint::root_abs(const bigint &n, uint64_t k)
+{
+    size_t len = n.size();
+    if (len <= 18)
+        return bigint(root_word(n.mod_word(1000000000000000000ULL), k));
+
+    // the root has at most `root_len` digits; if that is 1 or 2, search for it directly
+    size_t root_len = (len + k - 1) / k;
+    if (root_len <= 2)
+    {
+        uint64_t low = 1;
+        uint64_t high = root_len == 1 ? 10 : 100;
+        bigint magnitude = n.abs();
+        while (high - low > 1)
+        {
+            uint64_t mid = (low + high) / 2;
+            // mid^k has more digits than n whenever k log10(mid) >= len, so skip the power then
+            if (static_cast<double>(k) * std::log10(static_cast<double>(mid)) < static_cast<double>(len) + 1 && pow(bigint(mid), k) <= magnitude)
+                low = mid;
+            else
+                high = mid;
+        }
+        return bigint(low);
+    }
+
+    // (root(n / 10^(h k)) + 1) * 10^h is at least the root of n
+    size_t h = len / (2 * k);
+    bigint x = root_abs(n.slice(h * k, len), k) + bigint(1);
+    x.digits.insert(x.digits.end(), h, 0);
+
+    bigint magnitude = n.abs();
+    bigint_divisor index{bigint(k)};
+    while (true)
+    {
+        bigint y = index.div(x * bigint(k - 1) + bigint_divisor(pow(x, k - 1)).div(magnitude));
+        if (y >= x)
+            return x;
+        x = y;
+    }
+}
+
+bigint isqrt(const bigint &n)
+{
+    if (n.get_is_negative() && n != bigint(0))
+    {
+        throw std::invalid_argument("bigint::isqrt : Negative argument.");
+    }
+    return iroot(n, 2);
+}
+
+std::pair<bigint, bigint> isqrt_rem(const bigint &n)
+{
+    bigint root = isqrt(n);
+    bigint remainder = n - root.square();
+    return std::make_pair(root, remainder);
+}
+
+bigint iroot(const bigint &n, uint64_t k)
+{
+    if (k == 0)
+    {
+        throw std::invalid_argument("bigint::iroot : Root index must be positive.");
+    }
+    if (n.is_zero())
+        return bigint(0);
+    if (n.is_negative && k % 2 == 0)
+    {
+        throw std::invalid_argument("bigint::iroot : Even root of a negative number.");
+    }
+
+    bigint root = bigint::root_abs(n, k);
+    if (n.is_negative)
+        root = -root;
+    return root;
+}
+
+bool is_perfect_square(const bigint &n)
+{
+    if (n.is_zero())
+        return true;
+    if (n.is_negative)
+        return false;
+
+    // squares modulo 64, 63, 65 and 11 from one remainder by their product
+    uint64_t residue = n.mod_word(64 * 63 * 65 * 11);
+    for (uint64_t m : {64, 63, 65, 11})
+    {
+        bool square = false;
+        for (uint64_t x = 0; x < m && !square; x++)
+        {
+            square = x * x % m == residue % m;
+        }
+        if (!square)
+            return false;
+    }
+
+    bigint root = bigint::root_abs(n, 2);
+    return root.square() == n;
+}
+
+bool is_perfect_power(const bigint &n)
+{
+    if (n.is_zero() || n.abs() == bigint(1))
+        return true;
+    if (!n.is_negative && is_perfect_square(n))
+        return true;
+
+    auto is_prime = [](uint64_t p)
+    {
+        if (p < 2)
+            return false;
+        for (uint64_t d = 2; d * d <= p; d++)
+        {
+            if (p % d == 0)
+                return false;
+        }
+        return true;
+    };
+
+    // |n| < 10^len < 2^(4 len), so no exponent above 4 len can work
+    uint64_t max_exponent = 4 * n.size();
+    bigint magnitude = n.abs();
+    for (uint64_t k = 3; k <= max_exponent; k += 2)
+    {
+        if (!is_prime(k))
+            continue;
+
+        // a k-th power is 0 or a k-th power residue modulo every prime p = 1 (mod k)
+        bool candidate = true;
+        uint64_t filters = 0;
+        for (uint64_t p = 2 * k + 1; filters < 2 && p < 64 * k; p += 2 * k)
+        {
+            if (!is_prime(p))
+                continue;
+            ++filters;
+            uint64_t residue = n.mod_word(p);
+            if (residue == 0)
+                continue;
+            uint64_t power = 1;
+            for (uint64_t e = (p - 1) / k; e > 0; e >>= 1)
+            {
+                if (e & 1)
+                    power = power * residue % p;
+                residue = residue * residue % p;
+            }
+            if (power != 1)
+            {
+                candidate = false;
+                break;
+            }
+        }
+        if (!candidate)
+            continue;
+
+        bigint root = bigint::root_abs(n, k);
+        if (root == bigint(1))
+            break;
+        if (pow(root, k) == magnitude)
+            return true;
+    }
+    return false;
+}
+
+const std::vector<uint32_t> &bigint::small_primes()
+{
+    static const std::vector<uint32_t> primes = []
+    {
+        const uint32_t limit = 10000;
+        std::vector<bool> composite(limit, false);
+        std::vector<uint32_t> out;
+        for (uint32_t p = 2; p < limit; p++)
+        {
+            if (composite[p])
+                continue;
+            out.push_back(p);
+            for (uint32_t m = p * p; m < limit; m += p)
+            {
+                composite[m] = true;
+            }
+        }
+        return out;
+    }();
+    return primes;
+}
+
+std::vector<uint32_t> bigint::small_residues(const bigint &n, size_t count)
+{
+    const std::vector<uint32_t> &primes = small_primes();
+    std::vector<uint32_t> out(count);
+    size_t first = 0;
+    while (first < count)
+    {
+        uint64_t group = primes[first];
+        size_t last = first + 1;
+        while (last < count && group * primes[last] < 100000000000000000ULL)
+        {
+            group *= primes[last++];
+        }
+        uint64_t residue = n.mod_word(group);
+        for (size_t i = first; i < last; i++)
+        {
+            out[i] = static_cast<uint32_t>(residue % primes[i]);
+        }
+        first = last;
+    }
+    return out;
+}
+
+bool bigint::miller_rabin(const modular_context &context, const bigint &base)
+{
+    const bigint &n = context.get_modulus();
+    bigint n_minus_one = n - bigint(1);
+
+    // n - 1 = d * 2^s with d odd
+    bigint d = n_minus_one;
+    uint64_t s = 0;
+    bigint_divisor two{bigint(2)};
+    while (d.digits.back() % 2 == 0)
+    {
+        d = two.div(d);
+        ++s;
+    }
+
+    bigint one = context.to_montgomery(bigint(1));
+    bigint minus_one = context.to_montgomery(n_minus_one);
+    bigint x = context.to_montgomery(context.powmod(base, d));
+    if (x == one || x == minus_one)
+        return true;
+    for (uint64_t r = 1; r < s; r++)
+    {
+        x = context.sqrmod(x);
+        if (x == minus_one)
+            return true;
+        if (x == one)
+            return false;
+    }
+    return false;
+}
+
+bool bigint::strong_lucas(const modular_context &context)
+{
+    const bigint &n = context.get_modulus();
+
+    // Jacobi symbol (a / m) of words, m odd
+    auto jacobi = [](uint64_t a, uint64_t m)
+    {
+        int result = 1;
+        a %= m;
+        while (a != 0)
+        {
+            while (a % 2 == 0)
+            {
+                a /= 2;
+                if (m % 8 == 3 || m % 8 == 5)
+                    result = -result;
+            }
+            std::swap(a, m);
+            if (a % 4 == 3 && m % 4 == 3)
+                result = -result;
+            a %= m;
+        }
+        return m == 1 ? result : 0;
+    };
+
+    // Selfridge's method A: the first D in 5, -7, 9, -11, ... with (D / n) == -1
+    uint64_t n_mod_4 = n.mod_word(4);
+    int64_t D = 5;
+    for (uint64_t tries = 0;; tries++)
+    {
+        uint64_t a = static_cast<uint64_t>(D < 0 ? -D : D);
+        // (D / n) = (-1 / n)^[D < 0] * (n mod |D| / |D|) * (-1)^(((|D| - 1) / 2) ((n - 1) / 2))
+        int symbol = jacobi(n.mod_word(a), a);
+        if (D < 0 && n_mod_4 == 3)
+            symbol = -symbol;
+        if (a % 4 == 3 && n_mod_4 == 3)
+            symbol = -symbol;
+        if (symbol == -1)
+            break;
+        if (symbol == 0)
+            return false;
+        // no such D exists for squares
+        if (tries == 8 && is_perfect_square(n))
+            return false;
+        D = D > 0 ? -(D + 2) : -(D - 2);
+    }
+    int64_t Q = (1 - D) / 4;
+
+    auto add = [&n](const bigint &a, const bigint &b)
+    {
+        bigint sum = a + b;
+        return sum >= n ? sum - n : sum;
+    };
+    auto sub = [&n](const bigint &a, const bigint &b)
+    {
+        bigint difference = a - b;
+        return difference.get_is_negative() && difference != bigint(0) ? difference + n : difference;
+    };
+
+    bigint D_m = context.to_montgomery(D < 0 ? n + bigint(D) : bigint(D));
+    bigint Q_m = context.to_montgomery(Q < 0 ? n + bigint(Q) : bigint(Q));
+    bigint half = context.to_montgomery(bigint_divisor(bigint(2)).div(n + bigint(1)));
+
+    // n + 1 = d * 2^s with d odd
+    bigint d = n + bigint(1);
+    uint64_t s = 0;
+    bigint_divisor two{bigint(2)};
+    while (d.digits.back() % 2 == 0)
+    {
+        d = two.div(d);
+        ++s;
+    }
+
+    // U_1 = 1, V_1 = P = 1, then left to right over the remaining bits of d
+    bigint U = context.to_montgomery(bigint(1));
+    bigint V = U;
+    bigint Qk = Q_m;
+    std::vector<uint32_t> words = d.to_words();
+    int top = 31;
+    while ((words.back() >> top & 1) == 0)
+    {
+        --top;
+    }
+    for (size_t w = words.size(); w-- > 0;)
+    {
+        for (int bit = (w + 1 == words.size() ? top - 1 : 31); bit >= 0; bit--)
+        {
+            // U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k
+            U = context.mulmod(U, V);
+            V = sub(context.sqrmod(V), add(Qk, Qk));
+            Qk = context.sqrmod(Qk);
+            if (words[w] >> bit & 1)
+            {
+                // U_k+1 = (U_k + V_k) / 2, V_k+1 = (D U_k + V_k) / 2
+                bigint next_U = context.mulmod(add(U, V), half);
+                V = context.mulmod(add(context.mulmod(D_m, U), V), half);
+                U = next_U;
+                Qk = context.mulmod(Qk, Q_m);
+            }
+        }
+    }
+
+    if (U == bigint(0) || V == bigint(0))
+        return true;
+    for (uint64_t r = 1; r < s; r++)
+    {
+        V = sub(context.sqrmod(V), add(Qk, Qk));
+        Qk = context.sqrmod(Qk);
+        if (V == bigint(0))
+            return true;
+    }
+    return false;
+}
+
+bool is_probable_prime(const bigint &n)
+{
+    return is_probable_prime(n, 0);
+}
+
+bool is_probable_prime(const bigint &n, uint64_t rounds)
+{
+    if (n.get_is_negative() || n.size() == 0 || n == bigint(1))
+        return false;
+
+    // trial division by the primes below 1000 decides everything below 10^6
+    const std::vector<uint32_t> &primes = bigint::small_primes();
+    const size_t trial_count = 168;
+    std::vector<uint32_t> residues = bigint::small_residues(n, trial_count);
+    for (size_t i = 0; i < trial_count; i++)
+    {
+        if (residues[i] == 0)
+            return n == bigint(static_cast<int64_t>(primes[i]));
+    }
+    if (n < bigint(1000000))
+        return true;
+
+    modular_context context(n);
+    if (!bigint::miller_rabin(context, bigint(2)) || !bigint::strong_lucas(context))
+        return false;
+    for (uint64_t i = 0; i < rounds; i++)
+    {
+        if (!bigint::miller_rabin(context, bigint(static_cast<int64_t>(primes[(i + 1) % primes.size()]))))
+            return false;
+    }
+    return true;
+}
+
+bigint next_prime(const bigint &n)
+{
+    if (n < bigint(2))
+        return bigint(2);
+
+    bigint candidate = n + bigint(1);
+    if (candidate.digits.back() % 2 == 0)
+        candidate = candidate + bigint(1);
+    if (candidate < bigint(1000000))
+    {
+        while (!is_probable_prime(candidate))
+        {
+            candidate = candidate + bigint(2);
+        }
+        return candidate;
+    }
+
+    // sieve the odd numbers candidate + 2 i, i < window, by the odd primes below 10000
+    const std::vector<uint32_t> &primes = bigint::small_primes();
+    const size_t window = 64 + 4 * candidate.size();
+    while (true)
+    {
+        std::vector<uint32_t> residues = bigint::small_residues(candidate, primes.size());
+        std::vector<bool> composite(window, false);
+        for (size_t i = 1; i < primes.size(); i++)
+        {
+            // candidate + 2 j == 0 (mod p) for j == -residue / 2 (mod p)
+            uint64_t p = primes[i];
+            uint64_t start = (p - residues[i]) % p * ((p + 1) / 2) % p;
+            for (uint64_t j = start; j < window; j += p)
+            {
+                composite[j] = true;
+            }
+        }
+        for (size_t j = 0; j < window; j++)
+        {
+            if (composite[j])
+                continue;
+            bigint survivor = candidate + bigint(static_cast<int64_t>(2 * j));
+            if (is_probable_prime(survivor))
+                return survivor;
+        }
+        candidate = candidate + bigint(static_cast<int64_t>(2 * window));
+    }
+}
+
+bigint bigint::from_words(const std::vector<uint32_t> &words, bool negative)
+{
+    // Horner's rule in base 10^9 chunks, least significant chunk first
+    std::vector<uint32_t> chunks;
+    for (size_t w = words.size(); w-- > 0;)
+    {
+        uint64_t carry = words[w];
+        for (uint32_t &part : chunks)
+        {
+            uint64_t value = (static_cast<uint64_t>(part) << 32) + carry;
+            part = static_cast<uint32_t>(value % 1000000000);
+            carry = value / 1000000000;
+        }
+        while (carry != 0)
+        {
+            chunks.push_back(static_cast<uint32_t>(carry % 1000000000));
+            carry /= 1000000000;
+        }
+    }
+
+    bigint result;
+    if (chunks.empty())
+        return result;
+    BIGINT_RECORD_BYTES(0, chunks.size() * 9);
+    result.digits.clear();
+    result.digits.reserve(chunks.size() * 9);
+    for (size_t c = chunks.size(); c-- > 0;)
+    {
+        uint32_t part = chunks[c];
+        uint8_t buffer[9];
+        for (int i = 8; i >= 0; i--)
+        {
+            buffer[i] = static_cast<uint8_t>(part % 10);
+            part /= 10;
+        }
+        size_t first = 0;
+        if (c + 1 == chunks.size())
+        {
+            while (first < 8 && buffer[first] == 0)
+            {
+                ++first;
+            }
+        }
+        result.digits.insert(result.digits.end(), buffer + first, buffer + 9);
+    }
+    result.is_negative = negative;
+    return result;
+}
+
+bigint bigint::bitwise(const bigint &a, const bigint &b, uint32_t (*op)(uint32_t, uint32_t))
+{
+    BIGINT_RECORD(bitwise, std::max(a.digits.size(), b.digits.size()));
+    std::vector<uint32_t> x = a.to_words();
+    std::vector<uint32_t> y = b.to_words();
+    bool x_negative = a.is_negative && !x.empty();
+    bool y_negative = b.is_negative && !y.empty();
+    size_t width = std::max(x.size(), y.size()) + 1;
+    x.resize(width, 0);
+    y.resize(width, 0);
+
+    // ~(w - 1) turns a magnitude into its two's complement, sign extension included
+    auto complement = [](std::vector<uint32_t> &w)
+    {
+        for (uint32_t &word : w)
+        {
+            if (word-- != 0)
+                break;
+        }
+        for (uint32_t &word : w)
+        {
+            word = ~word;
+        }
+    };
+    if (x_negative)
+        complement(x);
+    if (y_negative)
+        complement(y);
+
+    std::vector<uint32_t> out(width);
+    for (size_t i = 0; i < width; i++)
+    {
+        out[i] = op(x[i], y[i]);
+    }
+    bool negative = op(x_negative ? 0xffffffffu : 0, y_negative ? 0xffffffffu : 0) != 0;
+
+    // back from two's complement: |n| = ~w + 1
+    if (negative)
+    {
+        for (uint32_t &word : out)
+        {
+            word = ~word;
+        }
+        for (uint32_t &word : out)
+        {
+            if (++word != 0)
+                break;
+        }
+    }
+    while (!out.empty() && out.back() == 0)
+    {
+        out.pop_back();
+    }
+    return from_words(out, negative);
+}
+
+bigint bigint::operator<<(uint64_t shift) const
+{
+    BIGINT_RECORD(shift, digits.size());
+    std::vector<uint32_t> words = to_words();
+    if (words.empty())
+        return bigint(0);
+
+    // whole words first, then one funnel-shift pass for the remaining bits
+    size_t word_shift = static_cast<size_t>(shift / 32);
+    unsigned bit_shift = static_cast<unsigned>(shift % 32);
+    std::vector<uint32_t> out(words.size() + word_shift + 1, 0);
+    for (size_t i = 0; i < words.size(); i++)
+    {
+        uint64_t value = static_cast<uint64_t>(words[i]) << bit_shift;
+        out[i + word_shift] |= static_cast<uint32_t>(value);
+        out[i + word_shift + 1] = static_cast<uint32_t>(value >> 32);
+    }
+    while (!out.empty() && out.back() == 0)
+    {
+        out.pop_back();
+    }
+    return from_words(out, is_negative);
+}
+
+bigint &bigint::operator<<=(uint64_t shift)
+{
+    *this = *this << shift;
+    return *this;
+}
+
+bigint bigint::operator>>(uint64_t shift) const
+{
+    BIGINT_RECORD(shift, digits.size());
+    std::vector<uint32_t> words = to_words();
+    if (words.empty())
+        return bigint(0);
+
+    // floor(-m / 2^k) = -(((m - 1) >> k) + 1)
+    bool negative = is_negative;
+    if (negative)
+    {
+        for (uint32_t &word : words)
+        {
+            if (word-- != 0)
+                break;
+        }
+    }
+
+    size_t word_shift = static_cast<size_t>(shift / 32);
+    unsigned bit_shift = static_cast<unsigned>(shift % 32);
+    std::vector<uint32_t> out;
+    if (word_shift < words.size())
+    {
+        out.resize(words.size() - word_shift);
+        for (size_t i = 0; i < out.size(); i++)
+        {
+            uint64_t high = i + word_shift + 1 < words.size() ? words[i + word_shift + 1] : 0;
+            uint64_t value = (high << 32 | words[i + word_shift]) >> bit_shift;
+            out[i] = static_cast<uint32_t>(value);
+        }
+    }
+    if (negative)
+    {
+        out.push_back(0);
+        for (uint32_t &word : out)
+        {
+            if (++word != 0)
+                break;
+        }
+    }
+    while (!out.empty() && out.back() == 0)
+    {
+        out.pop_back();
+    }
+    return from_words(out, negative);
+}
+
+bigint &bigint::operator>>=(uint64_t shift)
+{
+    *this = *this >> shift;
+    return *this;
+}
+
+bigint bigint::operator&(bigint const &other) const
+{
+    return bitwise(*this, other, [](uint32_t x, uint32_t y)
+                   { return x & y; });
+}
+
+bigint &bigint::operator&=(bigint const &other)
+{
+    *this = *this & other;
+    return *this;
+}
+
+bigint bigint::operator|(bigint const &other) const
+{
+    return bitwise(*this, other, [](uint32_t x, uint32_t y)
+                   { return x | y; });
+}
+
+bigint &bigint::operator|=(bigint const &other)
+{
+    *this = *this | other;
+    return *this;
+}
+
+bigint bigint::operator^(bigint const &other) const
+{
+    return bitwise(*this, other, [](uint32_t x, uint32_t y)
+                   { return x ^ y; });
+}
+
+bigint &bigint::operator^=(bigint const &other)
+{
+    *this = *this ^ other;
+    return *this;
+}
+
+BIGINT_CONSTEXPR bigint bigint::operator~() const
+{
+    return -*this - bigint(1);
+}
+
+uint64_t bigint::bit_length() const
+{
+    uint64_t magnitude = 0;
+    if (magnitude_word(magnitude))
+    {
+        uint64_t length = 0;
+        for (; magnitude != 0; magnitude >>= 1)
+        {
+            ++length;
+        }
+        return length;
+    }
+
+    // |*this| lies in [top * 10^rest, (top + 1) * 10^rest)
+    uint64_t rest = size() - 19;
+    uint64_t top = leading_digits(19);
+    long double scale = static_cast<long double>(rest) * 3.32192809488736234787L;
+    long double error = static_cast<long double>(rest + 64) * 16 * std::numeric_limits<long double>::epsilon();
+    uint64_t low = static_cast<uint64_t>(std::floor(std::log2(static_cast<long double>(top)) + scale - error));
+    uint64_t high = static_cast<uint64_t>(std::floor(std::log2(static_cast<long double>(top) + 1) + scale + error));
+    uint64_t length = low + 1;
+    for (uint64_t k = low + 1; k <= high; k++)
+    {
+        // a power of two inside the bracket has as many digits as the value, so the significant
+        // digits compare lexicographically
+        bigint power = pow(bigint(2), k);
+        auto first = digits.end() - static_cast<std::ptrdiff_t>(size());
+        auto power_first = power.digits.end() - static_cast<std::ptrdiff_t>(power.size());
+        if (power.size() < size() || (power.size() == size() && !std::lexicographical_compare(first, digits.end(), power_first, power.digits.end())))
+            length = k + 1;
+    }
+    return length;
+}
+
+uint64_t bigint::popcount() const
+{
+    uint64_t count = 0;
+    for (uint32_t word : to_words())
+    {
+        for (; word != 0; word &= word - 1)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool bigint::test_bit(uint64_t n) const
+{
+    std::vector<uint32_t> words = to_words();
+    bool negative = is_negative && !words.empty();
+    if (negative)
+    {
+        // bit n of ~(|x| - 1)
+        for (uint32_t &word : words)
+        {
+            if (word-- != 0)
+                break;
+        }
+    }
+    size_t index = static_cast<size_t>(n / 32);
+    bool bit = index < words.size() && (words[index] >> (n % 32) & 1);
+    return bit != negative;
+}
+
+bigint &bigint::set_bit(uint64_t n, bool value)
+{
+    if (test_bit(n) != value)
+        *this = *this ^ (bigint(1) << n);
+    return *this;
+}
+
+#ifdef BIGINT_SHARED_STORAGE
+bigint_storage::block::block(std::vector<uint8_t> digits) : references(1), data(std::move(digits))
+{
+    BIGINT_RECORD_BYTES(0, data.size());
+}
+
+void bigint_storage::release()
+{
+    if (shared && shared->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete shared;
+    shared = nullptr;
+}
+
+const std::vector<uint8_t> &bigint_storage::data() const
+{
+    static const std::vector<uint8_t> none;
+    return shared ? shared->data : none;
+}
+
+std::vector<uint8_t> &bigint_storage::mutable_data()
+{
+    if (!shared)
+    {
+        shared = new block(std::vector<uint8_t>());
+    }
+    else if (shared->references.load(std::memory_order_acquire) != 1)
+    {
+        BIGINT_RECORD_BYTES(shared->data.size(), 0);
+        block *copy = new block(shared->data);
+        release();
+        shared = copy;
+    }
+    return shared->data;
+}
+
+bigint_storage::bigint_storage() : shared(nullptr) {}
+
+bigint_storage::bigint_storage(const std::vector<uint8_t> &digits) : shared(digits.empty() ? nullptr : new block(digits)) {}
+
+bigint_storage::bigint_storage(const bigint_storage &other) : shared(other.shared)
+{
+    if (shared)
+        shared->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+bigint_storage::bigint_storage(bigint_storage &&other) noexcept : shared(other.shared)
+{
+    other.shared = nullptr;
+}
+
+bigint_storage &bigint_storage::operator=(const bigint_storage &other)
+{
+    if (shared != other.shared)
+    {
+        if (other.shared)
+            other.shared->references.fetch_add(1, std::memory_order_relaxed);
+        release();
+        shared = other.shared;
+    }
+    return *this;
+}
+
+bigint_storage &bigint_storage::operator=(bigint_storage &&other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        shared = other.shared;
+        other.shared = nullptr;
+    }
+    return *this;
+}
+
+bigint_storage &bigint_storage::operator=(const std::vector<uint8_t> &digits)
+{
+    if (shared && shared->references.load(std::memory_order_acquire) == 1)
+    {
+        shared->data = digits;
+        return *this;
+    }
+    release();
+    if (!digits.empty())
+        shared = new block(digits);
+    return *this;
+}
+
+bigint_storage::~bigint_storage()
+{
+    release();
+}
+
+bigint_storage::operator std::vector<uint8_t>() const
+{
+    return data();
+}
+
+bool bigint_storage::operator==(const bigint_storage &other) const
+{
+    return shared == other.shared || data() == other.data();
+}
+
+bool bigint_storage::is_shared() const
+{
+    return shared && shared->references.load(std::memory_order_acquire) > 1;
+}
+
+size_t bigint_storage::size() const
+{
+    return data().size();
+}
+
+bool bigint_storage::empty() const
+{
+    return data().empty();
+}
+
+uint8_t bigint_storage::operator[](size_t i) const
+{
+    return data()[i];
+}
+
+uint8_t &bigint_storage::operator[](size_t i)
+{
+    return mutable_data()[i];
+}
+
+uint8_t bigint_storage::back() const
+{
+    return data().back();
+}
+
+uint8_t &bigint_storage::back()
+{
+    return mutable_data().back();
+}
+
+bigint_storage::const_iterator bigint_storage::begin() const
+{
+    return data().begin();
+}
+
+bigint_storage::const_iterator bigint_storage::end() const
+{
+    return data().end();
+}
+
+bigint_storage::iterator bigint_storage::begin()
+{
+    return mutable_data().begin();
+}
+
+bigint_storage::iterator bigint_storage::end()
+{
+    return mutable_data().end();
+}
+
+bigint_storage::const_reverse_iterator bigint_storage::rbegin() const
+{
+    return data().rbegin();
+}
+
+bigint_storage::const_reverse_iterator bigint_storage::rend() const
+{
+    return data().rend();
+}
+
+void bigint_storage::push_back(uint8_t digit)
+{
+    mutable_data().push_back(digit);
+}
+
+void bigint_storage::pop_back()
+{
+    mutable_data().pop_back();
+}
+
+void bigint_storage::clear()
+{
+    if (shared && shared->references.load(std::memory_order_acquire) == 1)
+        shared->data.clear();
+    else
+        release();
+}
+
+void bigint_storage::reserve(size_t capacity)
+{
+    mutable_data().reserve(capacity);
+}
+
+void bigint_storage::resize(size_t count)
+{
+    mutable_data().resize(count);
+}
+
+bigint_storage::iterator bigint_storage::insert(iterator position, uint8_t digit)
+{
+    return mutable_data().insert(position, digit);
+}
+
+bigint_storage::iterator bigint_storage::insert(iterator position, size_t count, uint8_t digit)
+{
+    return mutable_data().insert(position, count, digit);
+}
+
+bigint_storage::iterator bigint_storage::erase(iterator position)
+{
+    return mutable_data().erase(position);
+}
+#endif
+
+bigint_batch::bigint_batch(size_t count, size_t width) : count(count), limbs_per_value(width), limbs(count * width, 0) {}
+
+bigint_batch::bigint_batch(const std::vector<bigint> &values) : count(values.size()), limbs_per_value(1)
+{
+    for (const bigint &value : values)
+    {
+        limbs_per_value = std::max(limbs_per_value, (value.size() + limb_digits - 1) / limb_digits + 1);
+    }
+    limbs.assign(count * limbs_per_value, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        set(i, values[i]);
+    }
+}
+
+size_t bigint_batch::size() const
+{
+    return count;
+}
+
+size_t bigint_batch::width() const
+{
+    return limbs_per_value;
+}
+
+bool bigint_batch::negative(size_t i) const
+{
+    return limbs_per_value > 0 && limbs[(limbs_per_value - 1) * count + i] >= limb_base / 2;
+}
+
+std::vector<uint32_t> bigint_batch::fill(size_t begin, size_t end) const
+{
+    std::vector<uint32_t> out(count, 0);
+    for (size_t i = begin; i < end; i++)
+    {
+        out[i] = negative(i) ? limb_base - 1 : 0;
+    }
+    return out;
+}
+
+std::vector<uint32_t> bigint_batch::magnitudes(size_t begin, size_t end) const
+{
+    size_t len = end - begin;
+    std::vector<uint32_t> out(limbs_per_value * len);
+    std::vector<uint32_t> carry(len);
+    std::vector<uint32_t> flip(len);
+    for (size_t i = 0; i < len; i++)
+    {
+        flip[i] = negative(begin + i) ? 1 : 0;
+        carry[i] = flip[i];
+    }
+
+    // |v| = 10^(9 width) - v = (each limb complemented) + 1 for negative values
+    for (size_t l = 0; l < limbs_per_value; l++)
+    {
+        const uint32_t *row = limbs.data() + l * count + begin;
+        uint32_t *target = out.data() + l * len;
+        for (size_t i = 0; i < len; i++)
+        {
+            uint32_t value = (flip[i] ? limb_base - 1 - row[i] : row[i]) + carry[i];
+            carry[i] = value >= limb_base;
+            target[i] = value - (carry[i] ? limb_base : 0);
+        }
+    }
+    return out;
+}
+
+void bigint_batch::negate(const std::vector<uint8_t> &flags, size_t begin, size_t end)
+{
+    size_t len = end - begin;
+    std::vector<uint32_t> carry(flags.begin(), flags.end());
+    for (size_t l = 0; l < limbs_per_value; l++)
+    {
+        uint32_t *row = limbs.data() + l * count + begin;
+        for (size_t i = 0; i < len; i++)
+        {
+            uint32_t value = (flags[i] ? limb_base - 1 - row[i] : row[i]) + carry[i];
+            carry[i] = value >= limb_base;
+            row[i] = value - (carry[i] ? limb_base : 0);
+        }
+    }
+}
+
+bigint bigint_batch::get(size_t i) const
+{
+    bool sign = negative(i);
+    std::vector<uint32_t> magnitude = magnitudes(i, i + 1);
+    bigint result;
+    result.digits.clear();
+    for (size_t l = magnitude.size(); l-- > 0;)
+    {
+        uint32_t part = magnitude[l];
+        for (uint32_t scale = limb_base / 10; scale > 0; scale /= 10)
+        {
+            uint8_t digit = static_cast<uint8_t>(part / scale % 10);
+            if (digit != 0 || !result.digits.empty())
+                result.digits.push_back(digit);
+        }
+    }
+    if (result.digits.empty())
+        return bigint(0);
+    result.is_negative = sign;
+    return result;
+}
+
+void bigint_batch::set(size_t i, const bigint &value)
+{
+    // magnitude limbs, least significant first
+    std::vector<uint32_t> magnitude;
+    size_t len = value.digits.size();
+    uint32_t limb = 0;
+    uint32_t scale = 1;
+    for (size_t d = 0; d < len; d++)
+    {
+        limb += scale * value.digits[len - 1 - d];
+        scale *= 10;
+        if (scale == limb_base || d + 1 == len)
+        {
+            magnitude.push_back(limb);
+            limb = 0;
+            scale = 1;
+        }
+    }
+    while (!magnitude.empty() && magnitude.back() == 0)
+    {
+        magnitude.pop_back();
+    }
+    bool flip = value.is_negative && !magnitude.empty();
+    std::vector<uint32_t> stored(limbs_per_value);
+    uint32_t carry = flip ? 1 : 0;
+    for (size_t l = 0; l < limbs_per_value; l++)
+    {
+        uint32_t part = l < magnitude.size() ? magnitude[l] : 0;
+        stored[l] = (flip ? limb_base - 1 - part : part) + carry;
+        carry = stored[l] >= limb_base;
+        stored[l] -= carry ? limb_base : 0;
+    }
+
+    // the representable range is [-10^(9 width) / 2, 10^(9 width) / 2)
+    if (magnitude.size() > limbs_per_value || limbs_per_value == 0 || (stored.back() >= limb_base / 2) != flip)
+    {
+        throw std::invalid_argument("bigint_batch::set : Value does not fit in the batch width.");
+    }
+    for (size_t l = 0; l < limbs_per_value; l++)
+    {
+        limbs[l * count + i] = stored[l];
+    }
+}
+
+std::vector<bigint> bigint_batch::to_vector() const
+{
+    std::vector<bigint> out;
+    out.reserve(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        out.push_back(get(i));
+    }
+    return out;
+}
+
+void bigint_batch::add_range(const bigint_batch &a, const bigint_batch &b, bool subtract, size_t begin, size_t end)
+{
+    size_t len = end - begin;
+    std::vector<uint32_t> fill_a = a.fill(begin, end);
+    std::vector<uint32_t> fill_b = b.fill(begin, end);
+    std::vector<uint32_t> carry(len, subtract ? 1 : 0);
+    uint32_t flip = subtract ? limb_base - 1 : 0;
+
+    // a - b = a + (10^(9 width) - 1 - b) + 1, with b sign-extended first
+    for (size_t l = 0; l < limbs_per_value; l++)
+    {
+        const uint32_t *row_a = (l < a.limbs_per_value ? a.limbs.data() + l * count : fill_a.data()) + begin;
+        const uint32_t *row_b = (l < b.limbs_per_value ? b.limbs.data() + l * count : fill_b.data()) + begin;
+        uint32_t *row = limbs.data() + l * count + begin;
+        for (size_t i = 0; i < len; i++)
+        {
+            uint32_t y = subtract ? flip - row_b[i] : row_b[i];
+            uint32_t sum = row_a[i] + y + carry[i];
+            carry[i] = sum >= limb_base;
+            row[i] = sum - (carry[i] ? limb_base : 0);
+        }
+    }
+}
+
+void bigint_batch::mul_range(const bigint_batch &a, const bigint_batch &b, size_t begin, size_t end)
+{
+    size_t len = end - begin;
+    size_t width_a = a.limbs_per_value;
+    size_t width_b = b.limbs_per_value;
+    std::vector<uint32_t> x = a.magnitudes(begin, end);
+    std::vector<uint32_t> y = b.magnitudes(begin, end);
+    std::vector<uint8_t> flags(len);
+    for (size_t i = 0; i < len; i++)
+    {
+        flags[i] = a.negative(begin + i) != b.negative(begin + i);
+    }
+
+    // schoolbook rows: (10^9 - 1) + (10^9 - 1)^2 + carry stays below 2^64
+    std::vector<uint64_t> carry(len);
+    for (size_t l = 0; l < limbs_per_value; l++)
+    {
+        std::fill(limbs.begin() + static_cast<std::ptrdiff_t>(l * count + begin), limbs.begin() + static_cast<std::ptrdiff_t>(l * count + end), 0);
+    }
+    for (size_t la = 0; la < width_a; la++)
+    {
+        const uint32_t *row_x = x.data() + la * len;
+        std::fill(carry.begin(), carry.end(), 0);
+        for (size_t lb = 0; lb < width_b; lb++)
+        {
+            const uint32_t *row_y = y.data() + lb * len;
+            uint32_t *row = limbs.data() + (la + lb) * count + begin;
+            for (size_t i = 0; i < len; i++)
+            {
+                uint64_t value = row[i] + static_cast<uint64_t>(row_x[i]) * row_y[i] + carry[i];
+                carry[i] = value / limb_base;
+                row[i] = static_cast<uint32_t>(value - carry[i] * limb_base);
+            }
+        }
+        uint32_t *row = limbs.data() + (la + width_b) * count + begin;
+        for (size_t i = 0; i < len; i++)
+        {
+            row[i] = static_cast<uint32_t>(carry[i]);
+        }
+    }
+    negate(flags, begin, end);
+}
+
+void bigint_batch::mod_range(const bigint_batch &a, const std::vector<uint32_t> &m, size_t begin, size_t end)
+{
+    size_t len = end - begin;
+    size_t k = m.size();
+    const int64_t base = limb_base;
+    std::vector<uint32_t> x = a.magnitudes(begin, end);
+
+    // running remainders r < m * 10^9 in k + 1 signed limb rows
+    std::vector<int64_t> r((k + 1) * len, 0);
+    std::vector<int64_t> q(len);
+    std::vector<int64_t> carry(len);
+    std::vector<int64_t> trial((k + 1) * len);
+    double divisor = k == 1 ? 0 : static_cast<double>(m[k - 1]) * limb_base + m[k - 2];
+
+    // r += sign * m, kept only where the result is non-negative (sign < 0) or where r is negative (sign > 0)
+    auto adjust = [&](int sign)
+    {
+        std::fill(carry.begin(), carry.end(), 0);
+        for (size_t j = 0; j <= k; j++)
+        {
+            int64_t limb = j < k ? static_cast<int64_t>(m[j]) * sign : 0;
+            for (size_t i = 0; i < len; i++)
+            {
+                int64_t value = r[j * len + i] + limb + carry[i];
+                carry[i] = j < k ? (value < 0 ? -1 : value >= base ? 1 : 0) : 0;
+                trial[j * len + i] = value - carry[i] * base;
+            }
+        }
+        for (size_t i = 0; i < len; i++)
+        {
+            bool take = sign < 0 ? trial[k * len + i] >= 0 : r[k * len + i] < 0;
+            for (size_t j = 0; j <= k; j++)
+            {
+                r[j * len + i] = take ? trial[j * len + i] : r[j * len + i];
+            }
+        }
+    };
+
+    for (size_t l = a.limbs_per_value; l-- > 0;)
+    {
+        // r = r * 10^9 + x_l
+        std::copy_backward(r.begin(), r.begin() + static_cast<std::ptrdiff_t>(k * len), r.begin() + static_cast<std::ptrdiff_t>((k + 1) * len));
+        for (size_t i = 0; i < len; i++)
+        {
+            r[i] = x[l * len + i];
+        }
+
+        // estimate each quotient limb from the leading limbs; it is off by at most two
+        for (size_t i = 0; i < len; i++)
+        {
+            if (k == 1)
+            {
+                q[i] = (r[len + i] * base + r[i]) / m[0];
+                continue;
+            }
+            double numerator = (static_cast<double>(r[k * len + i]) * limb_base + static_cast<double>(r[(k - 1) * len + i])) * limb_base + static_cast<double>(r[(k - 2) * len + i]);
+            double estimate = std::floor(numerator / divisor);
+            q[i] = estimate < 0 ? 0 : estimate > base - 1 ? base - 1 : static_cast<int64_t>(estimate);
+        }
+
+        // r -= q * m with a signed carry; the top limb may go negative
+        std::fill(carry.begin(), carry.end(), 0);
+        for (size_t j = 0; j <= k; j++)
+        {
+            int64_t limb = j < k ? m[j] : 0;
+            int64_t *row = r.data() + j * len;
+            for (size_t i = 0; i < len; i++)
+            {
+                int64_t value = row[i] - q[i] * limb + carry[i];
+                if (j == k)
+                {
+                    row[i] = value;
+                    continue;
+                }
+                int64_t borrow = value >= 0 ? value / base : -((-value + base - 1) / base);
+                carry[i] = borrow;
+                row[i] = value - borrow * base;
+            }
+        }
+        for (int pass = 0; pass < 3; pass++)
+        {
+            adjust(1);
+        }
+        for (int pass = 0; pass < 3; pass++)
+        {
+            adjust(-1);
+        }
     }
-    if (n)
+
+    // floor modulo: m - (|a| mod m) for negative a with a non-zero remainder
+    std::vector<uint8_t> flags(len);
+    for (size_t i = 0; i < len; i++)
     {
-        while (n)
+        bool zero = true;
+        for (size_t j = 0; j < k; j++)
         {
-            push_back(static_cast<uint8_t>(n % 10));
-            n /= 10;
+            zero = zero && r[j * len + i] == 0;
         }
-        std::reverse(begin(), end());
+        flags[i] = a.negative(begin + i) && !zero;
     }
-    else
+    for (size_t j = 0; j < limbs_per_value; j++)
     {
-        push_back(uint8_t(0));
+        uint32_t *row = limbs.data() + j * count + begin;
+        for (size_t i = 0; i < len; i++)
+        {
+            row[i] = j < k ? static_cast<uint32_t>(r[j * len + i]) : 0;
+        }
+    }
+    negate(flags, begin, end);
+    std::fill(carry.begin(), carry.end(), 0);
+    for (size_t j = 0; j < limbs_per_value; j++)
+    {
+        uint32_t *row = limbs.data() + j * count + begin;
+        for (size_t i = 0; i < len; i++)
+        {
+            int64_t value = static_cast<int64_t>(row[i]) + (flags[i] && j < k ? m[j] : 0) + carry[i];
+            carry[i] = value >= base;
+            row[i] = static_cast<uint32_t>(value - carry[i] * base);
+        }
     }
 }
-bigint::bigint(std::string n)
+
+bigint_batch bigint_batch::add(const bigint_batch &other, size_t threads) const
 {
-    if (n[0] == '-')
+    if (count != other.count)
     {
-        is_negative = true;
-        n = n.substr(1);
+        throw std::invalid_argument("bigint_batch::add : Batches have different sizes.");
     }
-    else if (n[0] == '+')
+    bigint_batch result(count, std::max(limbs_per_value, other.limbs_per_value) + 1);
+    parallel(count, threads, [&](size_t begin, size_t end)
+             { result.add_range(*this, other, false, begin, end); });
+    return result;
+}
+
+bigint_batch bigint_batch::sub(const bigint_batch &other, size_t threads) const
+{
+    if (count != other.count)
     {
-        is_negative = false;
-        n = n.substr(1);
+        throw std::invalid_argument("bigint_batch::sub : Batches have different sizes.");
     }
-    else
+    bigint_batch result(count, std::max(limbs_per_value, other.limbs_per_value) + 1);
+    parallel(count, threads, [&](size_t begin, size_t end)
+             { result.add_range(*this, other, true, begin, end); });
+    return result;
+}
+
+bigint_batch bigint_batch::mul(const bigint_batch &other, size_t threads) const
+{
+    if (count != other.count)
     {
-        is_negative = false;
+        throw std::invalid_argument("bigint_batch::mul : Batches have different sizes.");
     }
-    if (n.empty())
+    bigint_batch result(count, limbs_per_value + other.limbs_per_value);
+    parallel(count, threads, [&](size_t begin, size_t end)
+             { result.mul_range(*this, other, begin, end); });
+    return result;
+}
+
+std::vector<int> bigint_batch::compare(const bigint_batch &other, size_t threads) const
+{
+    if (count != other.count)
     {
-        throw std::invalid_argument("bigint::bigint : Input string is empty.");
+        throw std::invalid_argument("bigint_batch::compare : Batches have different sizes.");
     }
+    bigint_batch difference(count, std::max(limbs_per_value, other.limbs_per_value) + 1);
+    std::vector<int> out(count);
+    parallel(count, threads, [&](size_t begin, size_t end)
+             {
+                 difference.add_range(*this, other, true, begin, end);
+                 for (size_t i = begin; i < end; i++)
+                 {
+                     bool zero = true;
+                     for (size_t l = 0; l < difference.limbs_per_value; l++)
+                     {
+                         zero = zero && difference.limbs[l * count + i] == 0;
+                     }
+                     out[i] = difference.negative(i) ? -1 : zero ? 0 : 1;
+                 } });
+    return out;
+}
 
-    n.erase(0, n.find_first_not_of('0'));
-    if (n.empty())
+bigint_batch bigint_batch::mod(const bigint &m, size_t threads) const
+{
+    if (m <= bigint(0))
     {
-        n = "0";
+        throw std::invalid_argument("bigint_batch::mod : Modulus must be positive.");
+    }
+    bigint_batch single(std::vector<bigint>(1, m));
+    std::vector<uint32_t> modulus = single.magnitudes(0, 1);
+    while (modulus.back() == 0)
+    {
+        modulus.pop_back();
     }
 
-    for (char ch : n)
+    bigint_batch result(count, modulus.size() + 1);
+    parallel(count, threads, [&](size_t begin, size_t end)
+             { result.mod_range(*this, modulus, begin, end); });
+    return result;
+}
+
+bigint bigint::product_tree(const std::vector<bigint> &factors, size_t begin, size_t end, size_t threads)
+{
+    if (begin == end)
+        return bigint(1);
+    if (end - begin == 1)
+        return factors[begin];
+
+    size_t mid = begin + (end - begin) / 2;
+    if (threads > 1 && end - begin >= 8)
+    {
+        bigint left;
+        std::thread worker([&]()
+                           { left = product_tree(factors, begin, mid, threads / 2); });
+        bigint right = product_tree(factors, mid, end, threads - threads / 2);
+        worker.join();
+        return left * right;
+    }
+    return product_tree(factors, begin, mid, 1) * product_tree(factors, mid, end, 1);
+}
+
+bigint bigint::product_words(const std::vector<uint64_t> &words, size_t threads)
+{
+    std::vector<bigint> factors;
+    uint64_t packed = 1;
+    for (uint64_t word : words)
     {
-        if (!std::isdigit(ch))
+        if (packed > std::numeric_limits<uint64_t>::max() / word)
         {
+            factors.push_back(bigint(std::to_string(packed)));
+            packed = 1;
+        }
+        packed *= word;
+    }
+    if (packed > 1 || factors.empty())
+        factors.push_back(bigint(std::to_string(packed)));
+    return product_tree(factors, 0, factors.size(), threads);
+}
 
-            throw std::invalid_argument("bigint::bigint : Invalid character in input string: " + std::string(1, ch));
+bigint bigint::prime_power_product(const std::vector<uint64_t> &primes, const std::vector<uint64_t> &exponents, size_t threads)
+{
+    uint64_t top = 0;
+    for (uint64_t exponent : exponents)
+    {
+        top = std::max(top, exponent);
+    }
+
+    bigint result(1);
+    for (int bit = 63; bit >= 0; bit--)
+    {
+        if ((top >> bit) == 0)
+            continue;
+        std::vector<uint64_t> selected;
+        for (size_t i = 0; i < primes.size(); i++)
+        {
+            if ((exponents[i] >> bit) & 1)
+                selected.push_back(primes[i]);
+        }
+        if (threads == 1)
+        {
+            result = result.square() * product_words(selected, 1);
+            continue;
+        }
+
+        // square on a new thread while the selected primes are multiplied here
+        bigint squared;
+        std::thread worker([&]()
+                           { squared = result.square(); });
+        bigint primes_product = product_words(selected, threads - 1);
+        worker.join();
+
+        // the square is much longer than the primes: multiply its pieces on separate threads
+        size_t len = squared.digits.size();
+        size_t piece = std::max<size_t>((len + threads - 1) / threads, primes_product.digits.size());
+        std::vector<bigint> pieces((len + piece - 1) / piece);
+        std::vector<std::thread> workers;
+        for (size_t i = 0; i < pieces.size(); i++)
+        {
+            workers.emplace_back([&, i]()
+                                 { pieces[i] = squared.slice(i * piece, piece) * primes_product; });
+        }
+        bigint_columns columns(len + primes_product.digits.size() + 1);
+        for (size_t i = 0; i < pieces.size(); i++)
+        {
+            workers[i].join();
+            columns.add(pieces[i], false, i * piece);
+        }
+        result = columns.to_bigint();
+    }
+    return result;
+}
+
+std::vector<uint64_t> bigint::primes_up_to(uint64_t n)
+{
+    std::vector<uint64_t> primes;
+    if (n < 2)
+        return primes;
+    primes.push_back(2);
+
+    // composite[i] marks the odd number 2 i + 1
+    std::vector<bool> composite(n / 2 + 1, false);
+    for (uint64_t i = 1; 2 * i + 1 <= n; i++)
+    {
+        if (composite[i])
+            continue;
+        uint64_t p = 2 * i + 1;
+        primes.push_back(p);
+        for (uint64_t j = p * p / 2; p <= n / p && 2 * j + 1 <= n; j += p)
+        {
+            composite[j] = true;
+        }
+    }
+    return primes;
+}
+
+bigint product(const std::vector<bigint> &factors, size_t threads)
+{
+    return bigint::product_tree(factors, 0, factors.size(), std::max<size_t>(threads, 1));
+}
+
+bigint factorial(uint64_t n, size_t threads)
+{
+    std::vector<uint64_t> primes = bigint::primes_up_to(n);
+    std::vector<uint64_t> exponents(primes.size(), 0);
+    for (size_t i = 0; i < primes.size(); i++)
+    {
+        for (uint64_t m = n / primes[i]; m > 0; m /= primes[i])
+        {
+            exponents[i] += m;
+        }
+    }
+    return bigint::prime_power_product(primes, exponents, std::max<size_t>(threads, 1));
+}
+
+bigint binomial(uint64_t n, uint64_t k, size_t threads)
+{
+    if (k > n)
+        return bigint();
+    k = std::min(k, n - k);
+    threads = std::max<size_t>(threads, 1);
+
+    // terms[i] = n - k + 1 + i, stripped of the primes up to k
+    std::vector<uint64_t> terms(k);
+    for (uint64_t i = 0; i < k; i++)
+    {
+        terms[i] = n - k + 1 + i;
+    }
+    std::vector<uint64_t> primes = bigint::primes_up_to(k);
+    std::vector<uint64_t> exponents(primes.size(), 0);
+    for (size_t i = 0; i < primes.size(); i++)
+    {
+        uint64_t p = primes[i];
+        uint64_t first = (n - k + 1) % p == 0 ? 0 : p - (n - k + 1) % p;
+        uint64_t removed = 0;
+        for (uint64_t j = first; j < k; j += p)
+        {
+            do
+            {
+                terms[j] /= p;
+                removed++;
+            } while (terms[j] % p == 0);
+        }
+        for (uint64_t m = k / p; m > 0; m /= p)
+        {
+            removed -= m;
+        }
+        exponents[i] = removed;
+    }
+    return bigint::product_words(terms, threads) * bigint::prime_power_product(primes, exponents, threads);
+}
+
+#ifdef BIGINT_INSTRUMENT
+void bigint_instrument::totals::print(std::ostream &os) const
+{
+    os << "bytes copied: " << bytes_copied << ", bytes allocated: " << bytes_allocated << '\n';
+    for (size_t e = 0; e < event_count; e++)
+    {
+        if (calls[e] == 0)
+            continue;
+        os << name(static_cast<event>(e)) << ": " << calls[e] << " calls, digits";
+        for (size_t b = 0; b < buckets; b++)
+        {
+            if (sizes[e][b])
+                os << " [" << (b == 0 ? 0 : uint64_t(1) << (b - 1)) << ", " << (b == 0 ? 1 : b >= 64 ? UINT64_MAX : uint64_t(1) << b) << "): " << sizes[e][b];
+        }
+        os << '\n';
+    }
+}
+
+const char *bigint_instrument::name(event e)
+{
+    static const char *const names[event_count] = {"add", "sub", "mul", "square", "div", "pow", "gcd", "shift", "bitwise", "compare", "parse", "print", "copy", "get_digits", "mul_schoolbook", "mul_karatsuba", "sqr_schoolbook", "sqr_karatsuba"};
+    return e < event_count ? names[e] : "unknown";
+}
+
+void bigint_instrument::record(event e, uint64_t digits)
+{
+    counters &c = local();
+    size_t bucket = 0;
+    while (bucket < 64 && (digits >> bucket))
+    {
+        ++bucket;
+    }
+    c.calls[e].fetch_add(1, std::memory_order_relaxed);
+    c.sizes[e][bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void bigint_instrument::record_bytes(uint64_t copied, uint64_t allocated)
+{
+    counters &c = local();
+    c.bytes_copied.fetch_add(copied, std::memory_order_relaxed);
+    c.bytes_allocated.fetch_add(allocated, std::memory_order_relaxed);
+}
+
+bigint_instrument::totals bigint_instrument::collect()
+{
+    registry &r = shared();
+    std::lock_guard<std::mutex> guard(r.lock);
+    totals out = r.retired;
+    for (const counters *c : r.live)
+    {
+        c->add_to(out);
+    }
+    return out;
+}
+
+void bigint_instrument::reset()
+{
+    registry &r = shared();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.retired = totals();
+    for (counters *c : r.live)
+    {
+        c->clear();
+    }
+}
+
+void bigint_instrument::set_trace(trace_callback callback)
+{
+    shared().callback.store(callback, std::memory_order_release);
+}
+
+bigint_instrument::trace_callback bigint_instrument::trace()
+{
+    return shared().callback.load(std::memory_order_acquire);
+}
+
+bigint_instrument::counters::counters()
+{
+    clear();
+}
+
+void bigint_instrument::counters::add_to(totals &out) const
+{
+    for (size_t e = 0; e < event_count; e++)
+    {
+        out.calls[e] += calls[e].load(std::memory_order_relaxed);
+        for (size_t b = 0; b < buckets; b++)
+        {
+            out.sizes[e][b] += sizes[e][b].load(std::memory_order_relaxed);
+        }
+    }
+    out.bytes_copied += bytes_copied.load(std::memory_order_relaxed);
+    out.bytes_allocated += bytes_allocated.load(std::memory_order_relaxed);
+}
+
+void bigint_instrument::counters::clear()
+{
+    for (size_t e = 0; e < event_count; e++)
+    {
+        calls[e].store(0, std::memory_order_relaxed);
+        for (size_t b = 0; b < buckets; b++)
+        {
+            sizes[e][b].store(0, std::memory_order_relaxed);
+        }
+    }
+    bytes_copied.store(0, std::memory_order_relaxed);
+    bytes_allocated.store(0, std::memory_order_relaxed);
+}
+
+bigint_instrument::thread_handle::thread_handle() : local(new counters())
+{
+    registry &r = shared();
+    std::lock_guard<std::mutex> guard(r.lock);
+    r.live.push_back(local);
+}
+
+bigint_instrument::thread_handle::~thread_handle()
+{
+    registry &r = shared();
+    std::lock_guard<std::mutex> guard(r.lock);
+    local->add_to(r.retired);
+    r.live.erase(std::find(r.live.begin(), r.live.end(), local));
+    delete local;
+}
+
+void bigint_span::begin(bigint_instrument::event e)
+{
+    bigint_instrument::record(e, digits);
+    if (bigint_instrument::trace_callback callback = bigint_instrument::trace())
+    {
+        operation = bigint_instrument::name(e);
+        callback(operation, digits, true);
+    }
+}
+
+void bigint_span::end()
+{
+    if (bigint_instrument::trace_callback callback = bigint_instrument::trace())
+        callback(operation, digits, false);
+}
+
+bigint_instrument::registry &bigint_instrument::shared()
+{
+    // never destroyed, so threads that exit during static destruction can still fold their counters
+    static registry *r = new registry();
+    return *r;
+}
+
+bigint_instrument::counters &bigint_instrument::local()
+{
+    thread_local thread_handle handle;
+    return *handle.local;
+}
+#endif
+
+BIGINT_CONSTEXPR std::pair<uint64_t, uint64_t> bigint::hash_lanes(uint64_t seed, bool wide) const
+{
+    const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t prime3 = 0x165667B19E3779F9ULL;
+    const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+    auto rotl = [](uint64_t x, int r)
+    { return (x << r) | (x >> (64 - r)); };
+    auto avalanche = [](uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xC2B2AE3D27D4EB4FULL;
+        h ^= h >> 29;
+        h *= 0x165667B19E3779F9ULL;
+        h ^= h >> 32;
+        return h;
+    };
+
+    // leading zeros, including the single digit of a default-constructed 0, are not hashed
+    size_t first = 0;
+    while (first < digits.size() && digits[first] == 0)
+    {
+        ++first;
+    }
+    uint64_t length = digits.size() - first;
+    uint64_t low = seed + prime5 + length;
+    uint64_t high = (seed ^ prime4) + prime1 - length;
+    auto mix = [&](uint64_t word)
+    {
+        low ^= rotl(word * prime2, 31) * prime1;
+        low = rotl(low, 27) * prime1 + prime4;
+        if (wide)
+        {
+            high ^= rotl(word * prime3, 29) * prime2;
+            high = rotl(high, 31) * prime5 + prime1;
+        }
+    };
+
+    // sixteen digits per word, one per nibble, most significant digit first; the length
+    // in the seeds keeps a short final word apart from a zero-padded one
+    uint64_t word = 0;
+    uint64_t count = 0;
+    for (size_t i = first; i < digits.size(); i++)
+    {
+        word = (word << 4) | digits[i];
+        if (++count == 16)
+        {
+            mix(word);
+            word = 0;
+            count = 0;
+        }
+    }
+    if (count > 0)
+        mix(word);
+
+    if (is_negative && length > 0)
+    {
+        low ^= prime3;
+        high ^= prime2;
+    }
+    low = avalanche(low);
+    if (!wide)
+        return {low, 0};
+    high = avalanche(high);
+    low += high;
+    high += low;
+    return {low, high};
+}
+
+BIGINT_CONSTEXPR uint64_t bigint::hash64(uint64_t seed) const
+{
+    return hash_lanes(seed, false).first;
+}
+
+BIGINT_CONSTEXPR std::pair<uint64_t, uint64_t> bigint::hash128(uint64_t seed) const
+{
+    return hash_lanes(seed, true);
+}
+
+bigint_rns::basis::basis(uint64_t bits) : bits(bits)
+{
+    // every prime exceeds 2^30, so k primes give M > 2^(30 k) > 2^(bits + 1)
+    size_t k = static_cast<size_t>((bits + 1) / 30 + 1);
+    std::vector<uint32_t> small;
+    std::vector<uint8_t> small_composite(46341, 0);
+    for (uint32_t p = 2; p < 46341; p++)
+    {
+        if (small_composite[p])
+            continue;
+        small.push_back(p);
+        for (uint32_t j = p * p; j < 46341; j += p)
+        {
+            small_composite[j] = 1;
+        }
+    }
+
+    uint64_t high = uint64_t(1) << 31;
+    while (moduli.size() < k)
+    {
+        // about one number in 21 is prime near 2^31
+        uint64_t window = std::max<uint64_t>(uint64_t(1) << 16, 32 * (k - moduli.size()));
+        if (high - window <= (uint64_t(1) << 30))
+        {
+            throw std::invalid_argument("bigint_rns::bigint_rns : Bound is too large.");
+        }
+        uint64_t low = high - window;
+        std::vector<uint8_t> composite(window, 0);
+        for (uint32_t p : small)
+        {
+            for (uint64_t j = (low + p - 1) / p * p; j < high; j += p)
+            {
+                composite[j - low] = 1;
+            }
+        }
+        for (uint64_t x = high; x-- > low && moduli.size() < k;)
+        {
+            if (!composite[x - low])
+                moduli.push_back(static_cast<uint32_t>(x));
+        }
+        high = low;
+    }
+
+    inverses.assign(k, 0);
+    for (size_t i = 1; i < k; i++)
+    {
+        uint64_t m = moduli[i];
+        uint64_t prefix = 1;
+        for (size_t j = 0; j < i; j++)
+        {
+            prefix = prefix * (moduli[j] % m) % m;
+        }
+        // Fermat: prefix^(m - 2) mod m
+        uint64_t inverse = 1;
+        for (uint64_t e = m - 2; e > 0; e >>= 1)
+        {
+            if (e & 1)
+                inverse = inverse * prefix % m;
+            prefix = prefix * prefix % m;
+        }
+        inverses[i] = static_cast<uint32_t>(inverse);
+    }
+    products.resize(4 * k);
+    build(1, 0, k);
+}
+
+void bigint_rns::basis::build(size_t node, size_t begin, size_t end)
+{
+    if (end - begin == 1)
+    {
+        products[node] = bigint(static_cast<int64_t>(moduli[begin]));
+        return;
+    }
+    size_t mid = begin + (end - begin) / 2;
+    build(2 * node, begin, mid);
+    build(2 * node + 1, mid, end);
+    products[node] = products[2 * node] * products[2 * node + 1];
+}
+
+bigint_rns::bigint_rns(std::shared_ptr<const basis> shared) : shared(std::move(shared))
+{
+    residues.assign(this->shared->moduli.size(), 0);
+}
+
+bigint_rns::bigint_rns(const bigint &value, uint64_t bits, size_t threads) : bigint_rns(std::make_shared<const basis>(bits))
+{
+    load(value, threads);
+}
+
+bigint_rns::bigint_rns(const bigint &value, const bigint_rns &like, size_t threads) : bigint_rns(like.shared)
+{
+    load(value, threads);
+}
+
+void bigint_rns::load(const bigint &value, size_t threads)
+{
+    // limbs of 9 digits, most significant first
+    std::vector<uint32_t> limbs;
+    size_t len = value.digits.size();
+    for (size_t i = 0; i < len;)
+    {
+        size_t take = i == 0 && len % 9 != 0 ? len % 9 : 9;
+        uint32_t limb = 0;
+        for (size_t j = 0; j < take; j++)
+        {
+            limb = limb * 10 + value.digits[i + j];
         }
-        push_back(static_cast<uint8_t>(ch - '0'));
+        limbs.push_back(limb);
+        i += take;
     }
+    bool negative = value.get_is_negative();
+    const std::vector<uint32_t> &moduli = shared->moduli;
+    bigint_batch::parallel(moduli.size(), threads, [&](size_t begin, size_t end)
+                           {
+                               for (size_t i = begin; i < end; i++)
+                               {
+                                   uint64_t m = moduli[i];
+                                   uint64_t r = 0;
+                                   for (uint32_t limb : limbs)
+                                   {
+                                       r = (r * 1000000000 + limb) % m;
+                                   }
+                                   residues[i] = static_cast<uint32_t>(negative && r != 0 ? m - r : r);
+                               } });
 }
-bigint::bigint(const bigint &other) : digits(other.get_digits()), is_negative(other.get_is_negative()) {}
-// helpers
 
-uint8_t bigint::get_digit(const uint64_t n) const
+void bigint_rns::check_basis(const bigint_rns &other, const char *function) const
 {
-    return n >= size() ? 0 : get_digits()[n];
+    // the moduli depend only on their number, so bases of the same size are interchangeable
+    if (shared->moduli.size() != other.shared->moduli.size())
+    {
+        throw std::invalid_argument(std::string("bigint_rns::") + function + " : Values have different bases.");
+    }
 }
 
-std::vector<uint8_t> bigint::get_digits() const
+size_t bigint_rns::size() const
 {
-    return digits;
+    return residues.size();
 }
 
-bigint &bigint::set_digits(std::vector<uint8_t> n)
+uint64_t bigint_rns::bits() const
 {
-    digits = n;
-    return *this;
+    return shared->bits;
 }
 
-bigint &bigint::push_back(const uint8_t n)
+const std::vector<uint32_t> &bigint_rns::get_residues() const
 {
-    digits.push_back(n);
-    return *this;
+    return residues;
 }
 
-bigint &bigint::pop_back()
+const std::vector<uint32_t> &bigint_rns::get_moduli() const
 {
-    digits.pop_back();
-    return *this;
+    return shared->moduli;
 }
 
-std::vector<uint8_t>::iterator bigint::begin()
+bigint_rns bigint_rns::add(const bigint_rns &other, size_t threads) const
 {
-    return digits.begin();
+    check_basis(other, "add");
+    bigint_rns result(shared);
+    const std::vector<uint32_t> &moduli = shared->moduli;
+    bigint_batch::parallel(residues.size(), threads, [&](size_t begin, size_t end)
+                           {
+                               for (size_t i = begin; i < end; i++)
+                               {
+                                   uint32_t sum = residues[i] + other.residues[i];
+                                   result.residues[i] = sum >= moduli[i] ? sum - moduli[i] : sum;
+                               } });
+    return result;
 }
 
-std::vector<uint8_t>::iterator bigint::end()
+bigint_rns bigint_rns::sub(const bigint_rns &other, size_t threads) const
 {
-    return digits.end();
+    check_basis(other, "sub");
+    bigint_rns result(shared);
+    const std::vector<uint32_t> &moduli = shared->moduli;
+    bigint_batch::parallel(residues.size(), threads, [&](size_t begin, size_t end)
+                           {
+                               for (size_t i = begin; i < end; i++)
+                               {
+                                   uint32_t difference = residues[i] - other.residues[i];
+                                   result.residues[i] = residues[i] < other.residues[i] ? difference + moduli[i] : difference;
+                               } });
+    return result;
 }
 
-bigint &bigint::insert(std::vector<uint8_t>::iterator ind, const uint8_t num)
+bigint_rns bigint_rns::mul(const bigint_rns &other, size_t threads) const
 {
-    digits.insert(ind, num);
-    return *this;
+    check_basis(other, "mul");
+    bigint_rns result(shared);
+    const std::vector<uint32_t> &moduli = shared->moduli;
+    bigint_batch::parallel(residues.size(), threads, [&](size_t begin, size_t end)
+                           {
+                               for (size_t i = begin; i < end; i++)
+                               {
+                                   result.residues[i] = static_cast<uint32_t>(uint64_t(residues[i]) * other.residues[i] % moduli[i]);
+                               } });
+    return result;
 }
 
-bigint &bigint::erase(const std::vector<uint8_t>::iterator ind)
+bigint bigint_rns::combine(const std::vector<uint32_t> &digits, size_t node, size_t begin, size_t end, size_t threads) const
 {
-    digits.erase(ind);
-    return *this;
+    if (end - begin == 1)
+        return bigint(static_cast<int64_t>(digits[begin]));
+
+    size_t mid = begin + (end - begin) / 2;
+    bigint left;
+    bigint right;
+    if (threads > 1 && end - begin >= 16)
+    {
+        std::thread worker([&]()
+                           { left = combine(digits, 2 * node, begin, mid, threads / 2); });
+        right = combine(digits, 2 * node + 1, mid, end, threads - threads / 2);
+        worker.join();
+    }
+    else
+    {
+        left = combine(digits, 2 * node, begin, mid, 1);
+        right = combine(digits, 2 * node + 1, mid, end, 1);
+    }
+    return left + shared->products[2 * node] * right;
 }
 
-size_t bigint::size() const
+bigint bigint_rns::to_bigint(size_t threads) const
 {
-    if (is_zero())
-        return 0;
-    size_t length = get_digits().size();
-    std::size_t startIndex = 0;
+    const std::vector<uint32_t> &moduli = shared->moduli;
+    const std::vector<uint32_t> &inverses = shared->inverses;
+    size_t k = moduli.size();
 
-    while (startIndex < length && get_digits()[startIndex] == 0)
+    // Garner: v = c_0 + m_0 (c_1 + m_1 (c_2 + ...)) with 0 <= c_i < m_i
+    std::vector<uint32_t> digits(k);
+    for (size_t i = 0; i < k; i++)
     {
-        ++startIndex;
+        uint64_t m = moduli[i];
+        uint64_t partial = 0;
+        for (size_t j = i; j-- > 0;)
+        {
+            partial = (partial * (moduli[j] % m) + digits[j]) % m;
+        }
+        uint64_t difference = (residues[i] + m - partial) % m;
+        digits[i] = static_cast<uint32_t>(i == 0 ? difference : difference * inverses[i] % m);
     }
-    return length - startIndex;
+
+    bigint value = combine(digits, 1, 0, k, std::max<size_t>(threads, 1));
+    // values above M / 2 stand for negative numbers
+    const bigint &product = shared->products[1];
+    if (product < value + value)
+        return value - product;
+    return value;
 }
 
-bool bigint::get_is_negative() const
+bigint_rns bigint_rns::operator+(const bigint_rns &other) const
 {
-    return is_negative;
+    return add(other);
 }
 
-bigint &bigint::set_negative(bool neg)
+bigint_rns bigint_rns::operator-(const bigint_rns &other) const
 {
-    is_negative = neg;
-    return *this;
+    return sub(other);
 }
 
-// overloaded operators
-bigint bigint::operator+(bigint const &other) const
+bigint_rns bigint_rns::operator*(const bigint_rns &other) const
 {
-    bigint sum;
-
-    if (get_is_negative() == other.get_is_negative())
-    {
-        uint8_t carry = 0;
-        size_t this_len = size();
-        size_t other_len = other.size();
-        size_t len = std::max(this_len, other_len);
-
-        for (uint64_t i = 0; i < len; i++)
-        {
-            uint8_t sum_i = static_cast<uint8_t>(get_digit(this_len - 1 - i) + other.get_digit(other_len - 1 - i) + carry);
-            carry = static_cast<uint8_t>(sum_i / 10);
-            sum.insert(sum.begin(), static_cast<uint8_t>(sum_i % 10));
-        }
-        if (carry > 0)
-            sum.insert(sum.begin(), carry);
+    return mul(other);
+}
 
-        sum.set_negative(get_is_negative());
-        sum.pop_back();
-    }
-    else if (get_is_negative())
+bigint_rns bigint_rns::operator-() const
+{
+    bigint_rns result(shared);
+    for (size_t i = 0; i < residues.size(); i++)
     {
-        sum = -(-*this - other);
+        result.residues[i] = residues[i] == 0 ? 0 : shared->moduli[i] - residues[i];
     }
-    else
-        sum = *this - (-other);
+    return result;
+}
 
-    return sum;
+bigint_rns &bigint_rns::operator+=(const bigint_rns &other)
+{
+    *this = add(other);
+    return *this;
 }
 
-bigint &bigint::operator+=(bigint const &increment)
+bigint_rns &bigint_rns::operator-=(const bigint_rns &other)
 {
-    *this = *this + increment;
+    *this = sub(other);
     return *this;
 }
 
-bigint &bigint::operator++()
+bigint_rns &bigint_rns::operator*=(const bigint_rns &other)
 {
-    return *this += bigint(1);
+    *this = mul(other);
+    return *this;
 }
 
-bigint bigint::operator++(int)
+bool bigint_rns::operator==(const bigint_rns &other) const
 {
-    bigint temp = *this;
-    ++(*this);
-    return temp;
+    check_basis(other, "operator==");
+    return residues == other.residues;
 }
 
-bigint bigint::operator-(bigint const &other) const
+bool bigint_rns::operator!=(const bigint_rns &other) const
 {
-    bigint diff;
+    return !(*this == other);
+}
 
-    if (get_is_negative() == other.get_is_negative())
+uint64_t bigint_divisor::divide_limbs(std::vector<uint64_t> &limbs, uint64_t d)
+{
+    uint64_t remainder = 0;
+    for (size_t i = limbs.size(); i-- > 0;)
     {
-        diff.set_negative(*this >= other ? 0 : 1);
-
-        bigint pos_num;
-        bigint neg_num;
-
-        if (abs() > other.abs())
-        {
-            pos_num = *this;
-            neg_num = other;
-        }
-        else
-        {
-            pos_num = other;
-            neg_num = *this;
-        }
-
-        size_t pos_len = pos_num.size();
-        size_t neg_len = neg_num.size();
-        size_t len = std::max(pos_len, neg_len);
-
-        uint8_t borrow = 0;
-
-        for (uint64_t i = 0; i < len; i++)
-        {
-            uint8_t pos_i = pos_num.get_digit(pos_len - 1 - i);
-            uint8_t neg_i = neg_num.get_digit(neg_len - 1 - i);
-            uint8_t diff_i;
-
-            if (pos_i < (neg_i + borrow))
-            {
-                diff_i = static_cast<uint8_t>(neg_i - pos_i + borrow);
-                borrow = 1;
-                diff_i = static_cast<uint8_t>(10 - diff_i);
-            }
-            else
-            {
-                diff_i = static_cast<uint8_t>(pos_i - neg_i - borrow);
-                borrow = 0;
-            }
-            diff.insert(diff.begin(), diff_i);
-        }
-
-        diff.pop_back();
-        uint64_t max_zero_iter = diff.get_digits().size() - 1;
-        for (uint64_t j = 0; j < max_zero_iter; j++)
-        {
-            if (diff.get_digit(0) == 0)
-            {
-                diff.erase(diff.begin());
-            }
-            else
-                break;
-        }
+        uint64_t value = remainder * limb_base + limbs[i];
+        limbs[i] = value / d;
+        remainder = value % d;
     }
-    else if (get_is_negative())
+    while (!limbs.empty() && limbs.back() == 0)
     {
-        diff = -(-*this + other);
+        limbs.pop_back();
     }
-    else
-        diff = *this + (-other);
-    return diff;
+    return remainder;
 }
 
-bigint &bigint::operator-=(bigint const &decrement)
+bool divisible_by(const bigint &a, const bigint &d)
 {
-    *this = *this - decrement;
-    return *this;
-}
+    if (d.is_zero())
+    {
+        throw std::invalid_argument("divisible_by : Division by zero.");
+    }
+    if (a.is_zero())
+        return true;
+    // a multiple of d shares its factors 2 and 5, and a nonzero multiple is at least as long
+    uint8_t a_last = bigint_divisor::last_digit(a);
+    uint8_t d_last = bigint_divisor::last_digit(d);
+    if ((d_last % 2 == 0 && a_last % 2 != 0) || (d_last % 5 == 0 && a_last % 5 != 0))
+        return false;
+    if (a.size() < d.size())
+        return false;
 
-bigint &bigint::operator--()
-{
-    return *this -= bigint(1);
+    // the Hensel quotient q of m limbs satisfies q * v == u modulo 10^(9 m), and v divides u
+    // exactly when u - q * v is zero without a borrow out of the top limb
+    std::vector<uint64_t> u = bigint_divisor::pack(a);
+    std::vector<uint64_t> v = bigint_divisor::pack(d);
+    if (!bigint_divisor::strip_factors(u, v))
+        return false;
+    if (u.size() < v.size())
+        return false;
+    size_t m = u.size() - v.size() + 1;
+    if (bigint_divisor::hensel(u, v, m))
+        return false;
+    return std::all_of(u.begin() + static_cast<std::ptrdiff_t>(m), u.end(), [](uint64_t limb)
+                       { return limb == 0; });
 }
 
-bigint bigint::operator--(int)
+bool divisible_by_2exp(const bigint &a, uint64_t k)
 {
-    bigint temp = *this;
-    --(*this);
-    return temp;
+    if (a.is_zero())
+        return true;
+    // 2^k divides 10^k, so a and its last k digits have the same residue modulo 2^k
+    std::vector<uint64_t> limbs = bigint_divisor::pack(a.slice(0, static_cast<size_t>(std::min<uint64_t>(k, a.digits.size()))));
+    while (k > 0 && !limbs.empty())
+    {
+        uint64_t step = std::min<uint64_t>(k, 29);
+        if (bigint_divisor::divide_limbs(limbs, uint64_t(1) << step) != 0)
+            return false;
+        k -= step;
+    }
+    return true;
 }
 
-bigint bigint::operator*(bigint const &other) const
+bool bigint_divisor::strip_factors(std::vector<uint64_t> &u, std::vector<uint64_t> &v)
 {
-    bigint prod;
-
-    if (is_zero() || other.is_zero())
-        return prod;
-
-    uint8_t carry = 0;
-    size_t inner_iter = size();
-    size_t outer_iter = other.size();
-
-    for (uint64_t i = 0; i < outer_iter; i++)
+    size_t zeros = 0;
+    while (v[zeros] == 0)
+    {
+        ++zeros;
+    }
+    for (size_t i = 0; i < std::min(zeros, u.size()); i++)
+    {
+        if (u[i] != 0)
+            return false;
+    }
+    v.erase(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(zeros));
+    u.erase(u.begin(), u.begin() + static_cast<std::ptrdiff_t>(std::min(zeros, u.size())));
+    // the factors 10, 2 and 5 of the low limb divide all of v as long as they divide 10^9
+    bool exact = true;
+    for (uint64_t prime : {uint64_t(10), uint64_t(2), uint64_t(5)})
     {
-        bigint digits_i;
-        for (uint64_t j = 0; j < inner_iter; j++)
+        while (v[0] % prime == 0)
         {
-            uint8_t prod_i = static_cast<uint8_t>(other.get_digit(outer_iter - 1 - i) * get_digit(inner_iter - 1 - j) + carry);
-            carry = static_cast<uint8_t>(prod_i / 10);
-            uint8_t digits_i_j = static_cast<uint8_t>(prod_i % 10);
-
-            digits_i.insert(digits_i.begin(), digits_i_j);
+            uint64_t factor = prime;
+            while (factor * prime <= limb_base && limb_base % (factor * prime) == 0 && v[0] % (factor * prime) == 0)
+            {
+                factor *= prime;
+            }
+            divide_limbs(v, factor);
+            exact = divide_limbs(u, factor) == 0 && exact;
         }
-        for (uint64_t k = 0; k < i; k++)
+    }
+    return exact;
+}
+
+bool bigint_divisor::hensel(std::vector<uint64_t> &u, const std::vector<uint64_t> &v, size_t count)
+{
+    const uint64_t base = limb_base;
+    // v[0]^-1 mod 10^9 by Newton iteration from the inverse modulo 10, doubling the digits each step
+    uint64_t inverse = v[0] % 10 == 1 ? 1 : v[0] % 10 == 3 ? 7 : v[0] % 10 == 7 ? 3 : 9;
+    for (int step = 0; step < 4; step++)
+    {
+        inverse = inverse * ((base + 2 - v[0] * inverse % base) % base) % base;
+    }
+    size_t length = u.size();
+    bool underflow = false;
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t digit = u[i] * inverse % base;
+        // u[i ..) -= digit * v, which clears u[i]
+        uint64_t carry = 0;
+        int64_t borrow = 0;
+        size_t end = std::min(length, i + v.size());
+        const uint64_t *divisor = v.data() - i;
+        for (size_t j = i; j < end; j++)
         {
-            digits_i.push_back(uint8_t(0));
+            uint64_t product = digit * divisor[j] + carry;
+            carry = product / base;
+            int64_t value = static_cast<int64_t>(u[j]) - static_cast<int64_t>(product - carry * base) - borrow;
+            borrow = value < 0;
+            u[j] = static_cast<uint64_t>(value + borrow * static_cast<int64_t>(base));
         }
-
-        if (carry > 0)
+        for (size_t j = end; j < length && (carry != 0 || borrow != 0); j++)
         {
-            digits_i.insert(digits_i.begin(), carry);
+            int64_t value = static_cast<int64_t>(u[j]) - static_cast<int64_t>(carry) - borrow;
             carry = 0;
+            borrow = value < 0;
+            u[j] = static_cast<uint64_t>(value + borrow * static_cast<int64_t>(base));
         }
-
-        digits_i.pop_back();
-        bigint prodArch = prod;
-        prod += digits_i;
+        u[i] = digit;
+        // once u - quotient * v is negative it stays negative, since every step subtracts more
+        underflow = underflow || carry != 0 || borrow != 0 || (digit != 0 && i + v.size() > length);
     }
-
-    prod.set_negative(!(get_is_negative() == other.get_is_negative()));
-    return prod;
+    return underflow;
 }
 
-bigint &bigint::operator*=(bigint const &multiplier)
+bigint divexact(const bigint &a, const bigint &d)
 {
-    *this = *this * multiplier;
-    return *this;
-}
+    std::vector<uint64_t> v = bigint_divisor::pack(d);
+    if (v.empty())
+    {
+        throw std::invalid_argument("divexact : Division by zero.");
+    }
+    std::vector<uint64_t> u = bigint_divisor::pack(a);
+    bool negative = a.get_is_negative() != d.get_is_negative();
+    bigint_divisor::strip_factors(u, v);
+    if (u.size() < v.size())
+        return bigint();
 
-bigint bigint::operator-() const
-{
-    bigint flip = *this;
-    flip.set_negative(!get_is_negative());
+    // the quotient q has at most m limbs; Hensel division finds it modulo 10^(9 m) from the low
+    // limbs of both operands alone
+    size_t m = u.size() - v.size() + 1;
+    size_t low = m - m / 2;
+    size_t top = m - low + 1;
+    // below this many top limbs the setup of the top division costs more than it saves
+    const size_t split_limbs = 16;
+    if (top < split_limbs || v.size() < top)
+    {
+        u.resize(m);
+        v.resize(std::min(v.size(), m));
+        bigint_divisor::hensel(u, v, m);
+        return bigint_divisor::unpack(u, negative);
+    }
 
-    return flip;
-}
+    // dividing the limbs of u from `drop + low` up by the `top` leading limbs of v gives Q with
+    // -10^(9 low) < Q * 10^(9 low) - q < 2 * 10^(9 low), and Hensel division gives q modulo
+    // 10^(9 (low + 1)); together they fix q
+    size_t drop = v.size() - top;
+    std::vector<uint64_t> top_v(v.begin() + static_cast<std::ptrdiff_t>(drop), v.end());
+    std::vector<uint64_t> top_u(u.begin() + static_cast<std::ptrdiff_t>(drop + low), u.end());
+    std::vector<uint64_t> estimate;
+    std::vector<uint64_t> remainder;
+    bigint_divisor(bigint_divisor::unpack(top_v, false)).run(bigint_divisor::unpack(top_u, false), &estimate, remainder);
 
-bigint bigint::abs() const
-{
-    bigint abs = *this;
-    abs.set_negative(0);
+    u.resize(low + 1);
+    v.resize(std::min(v.size(), low + 1));
+    bigint_divisor::hensel(u, v, low + 1);
 
-    return abs;
+    // q = Q * 10^(9 low) - e with e = (Q * 10^(9 low) - q) mod 10^(9 (low + 1)), taken negative
+    // when its top limb shows it wrapped around
+    const int64_t base = static_cast<int64_t>(bigint_divisor::limb_base);
+    std::vector<uint64_t> quotient(low + estimate.size() + 1, 0);
+    std::copy(estimate.begin(), estimate.end(), quotient.begin() + static_cast<std::ptrdiff_t>(low));
+    std::vector<uint64_t> excess(low + 1);
+    int64_t borrow = 0;
+    for (size_t i = 0; i <= low; i++)
+    {
+        int64_t value = static_cast<int64_t>(quotient[i]) - static_cast<int64_t>(u[i]) - borrow;
+        borrow = value < 0;
+        excess[i] = static_cast<uint64_t>(value + borrow * base);
+    }
+    bool wrapped = excess[low] == bigint_divisor::limb_base - 1;
+    borrow = 0;
+    for (size_t i = 0; i < quotient.size() && (i <= low || borrow != 0); i++)
+    {
+        int64_t value = static_cast<int64_t>(quotient[i]) - static_cast<int64_t>(i <= low ? excess[i] : 0) - borrow;
+        borrow = value < 0;
+        quotient[i] = static_cast<uint64_t>(value + borrow * base);
+    }
+    for (size_t i = low + 1; wrapped && i < quotient.size(); i++)
+    {
+        wrapped = ++quotient[i] == bigint_divisor::limb_base;
+        if (wrapped)
+            quotient[i] = 0;
+    }
+    return bigint_divisor::unpack(quotient, negative);
 }
 
-bool bigint::operator==(bigint const &other) const
+BIGINT_CONSTEXPR uint64_t bigint::leading_digits(size_t count) const
 {
-
-    if (get_is_negative() == other.get_is_negative() && get_digits() == other.get_digits())
-        return true;
-    else
+    uint64_t value = 0;
+    size_t first = digits.size() - size();
+    size_t last = first + std::min(count, size());
+    for (size_t i = first; i < last; i++)
     {
-        if (is_zero() && other.is_zero())
-            return true;
-        else
-        {
-            return false;
-        }
+        value = value * 10 + digits[i];
     }
+    return value;
 }
 
-bool bigint::is_zero() const
+BIGINT_CONSTEXPR bool bigint::magnitude_word(uint64_t &magnitude) const
 {
-    for (const uint8_t &digit : get_digits())
+    size_t length = size();
+    if (length > 20)
+        return false;
+    magnitude = leading_digits(19);
+    if (length == 20)
     {
-        if (digit != 0)
-        {
+        uint64_t last = digits.back();
+        if (magnitude > (std::numeric_limits<uint64_t>::max() - last) / 10)
             return false;
-        }
+        magnitude = magnitude * 10 + last;
     }
     return true;
 }
 
-bool bigint::operator!=(bigint const &other) const
+template <typename T>
+T bigint::to_floating() const
 {
-    return !(*this == other);
-}
+    uint64_t magnitude = 0;
+    if (size() <= 19 && magnitude_word(magnitude))
+    {
+        T value = static_cast<T>(magnitude);
+        return is_negative && magnitude != 0 ? -value : value;
+    }
+    if (size() > static_cast<size_t>(std::numeric_limits<T>::max_exponent10) + 1)
+        return is_negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
 
-bool bigint::operator<(bigint const &other) const
-{
-    if (*this == other)
-        return false;
-    else if (get_is_negative() != other.get_is_negative())
-        return get_is_negative();
-    else if (size() > other.size())
+    std::vector<uint32_t> words = to_words();
+    uint64_t bits = 32 * (words.size() - 1);
+    for (uint32_t top = words.back(); top != 0; top >>= 1)
     {
-        return get_is_negative();
+        ++bits;
     }
-    else if (size() == other.size())
+    auto bit = [&words](uint64_t n)
     {
-        for (uint64_t i = 0; i < size(); i++)
+        return (words[n / 32] >> (n % 32)) & 1;
+    };
+
+    // the leading `digits` bits are exact in T; round on the next bit and the sticky bits below it
+    uint64_t precision = static_cast<uint64_t>(std::numeric_limits<T>::digits);
+    uint64_t shift = bits > precision ? bits - precision : 0;
+    T value = 0;
+    for (uint64_t n = bits; n-- > shift;)
+    {
+        value = value * 2 + static_cast<T>(bit(n));
+    }
+    if (shift > 0 && bit(shift - 1))
+    {
+        bool sticky = (words[(shift - 1) / 32] & ((uint32_t(1) << ((shift - 1) % 32)) - 1)) != 0;
+        for (uint64_t i = 0; i < (shift - 1) / 32 && !sticky; i++)
         {
-            if (get_digit(i) != other.get_digit(i))
-                return get_digit(i) > other.get_digit(i) ? get_is_negative() : !get_is_negative();
+            sticky = words[i] != 0;
         }
-        return false;
+        if (sticky || bit(shift))
+            value += 1;
     }
-    else
-        return !get_is_negative();
+    value = std::ldexp(value, static_cast<int>(shift));
+    return is_negative ? -value : value;
 }
 
-bool bigint::operator>(bigint const &other) const
+double bigint::to_double() const
 {
-    return other < *this;
+    return to_floating<double>();
 }
-bool bigint::operator<=(bigint const &other) const
+
+long double bigint::to_long_double() const
 {
-    return other == *this || *this < other;
+    return to_floating<long double>();
 }
-bool bigint::operator>=(bigint const &other) const
+
+bigint bigint::from_double(double x)
 {
-    return other == *this || *this > other;
+    if (!std::isfinite(x))
+        throw std::invalid_argument("bigint::from_double : Value is not finite.");
+    x = std::trunc(x);
+    if (std::fabs(x) < 9223372036854775808.0)
+        return bigint(static_cast<int64_t>(x));
+
+    // x = mantissa * 2^(exponent - 53) with a 53-bit integer mantissa
+    int exponent = 0;
+    double fraction = std::frexp(x, &exponent);
+    int64_t mantissa = static_cast<int64_t>(std::ldexp(fraction, 53));
+    return bigint(mantissa) * pow(bigint(2), static_cast<uint64_t>(exponent - 53));
 }
 
-bigint &bigint::operator=(const bigint &other)
+BIGINT_CONSTEXPR bool bigint::fits_int64() const
 {
-    set_negative(other.get_is_negative());
-    set_digits(other.get_digits());
-    return *this;
+    uint64_t magnitude = 0;
+    if (!magnitude_word(magnitude))
+        return false;
+    return magnitude <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (is_negative ? 1 : 0);
 }
 
-std::ostream &operator<<(std::ostream &os, const bigint &n)
+BIGINT_CONSTEXPR int64_t bigint::to_int64() const
 {
-    if (n.get_is_negative())
-    {
-        os << '-';
-    }
-    for (uint8_t digit : n.get_digits())
-    {
-        os << static_cast<uint16_t>(digit);
-    }
-    return os;
+    if (!fits_int64())
+        throw std::invalid_argument("bigint::to_int64 : Value does not fit in int64_t.");
+    uint64_t magnitude = 0;
+    magnitude_word(magnitude);
+    // negate in unsigned arithmetic so that the minimum converts without overflow
+    return static_cast<int64_t>(is_negative ? 0 - magnitude : magnitude);
+}
+
+BIGINT_CONSTEXPR uint64_t bigint::to_uint64() const
+{
+    uint64_t magnitude = 0;
+    if (!magnitude_word(magnitude) || (is_negative && magnitude != 0))
+        throw std::invalid_argument("bigint::to_uint64 : Value does not fit in uint64_t.");
+    return magnitude;
+}
+
+BIGINT_CONSTEXPR uint64_t bigint::decimal_digit_count() const
+{
+    return std::max<uint64_t>(size(), 1);
+}
+
+double bigint::log2() const
+{
+    return static_cast<double>(log10()) * 3.32192809488736234787;
+}
+
+double bigint::log10() const
+{
+    if (is_zero())
+        return -std::numeric_limits<double>::infinity();
+    uint64_t length = size();
+    uint64_t count = std::min<uint64_t>(length, 19);
+    return static_cast<double>(std::log10(static_cast<long double>(leading_digits(19))) + static_cast<long double>(length - count));
 }
\ No newline at end of file
@@ -13,6 +13,13 @@
 #include <sstream>
 #include <cassert>
 #include <random>
+#include <thread>
+#include <numeric>
+#include <list>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstring>
 
 /**
  * @brief Converts a string of digits to a vector of `uint8_t`.
@@ -358,7 +365,7 @@ void edge_test()
         EXIT_FAILURE;
     }
 
-    uint64_t total_tests = 11;
+    uint64_t total_tests = 13;
 
     bigint zero = bigint(0);
     bigint one = bigint(1);
@@ -387,6 +394,10 @@ void edge_test()
     assert((one + n_one == zero) && "Addition test failed!");
     std::cout << "(zero - one == n_one)" << '\n';
     assert((zero - one == n_one) && "Subtraction test failed!");
+    std::cout << "(zero - zero == zero)" << '\n';
+    assert((zero - zero == zero) && "Subtraction test failed!");
+    std::cout << "(-zero - zero == zero)" << '\n';
+    assert((-zero - zero == zero) && "Subtraction test failed!");
 
     std::cout << "Edge tests passed: " << total_tests << '\n';
     std::cout << "------------------------------------------------" << std::endl;
@@ -464,6 +475,2083 @@ void exception_test()
     logFile.close();
 }
 
+/**
+ * @brief Unit tests for compile-time evaluation and the `_big` literal.
+ *
+ */
+void constexpr_test()
+{
+    std::ofstream logFile("./unit_test_constexpr.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 2;
+
+#if BIGINT_HAS_CONSTEXPR
+    static_assert(bigint("1000000007") * bigint("1000000007") == bigint("1000000014000000049"), "Compile-time multiplication failed!");
+    static_assert(1000000007_big + 1_big == bigint(1000000008), "Compile-time addition failed!");
+    static_assert(-12345678901234567890_big - 1_big == bigint("-12345678901234567891"), "Compile-time subtraction failed!");
+    static_assert(99999999999999999999_big < 100000000000000000000_big, "Compile-time comparison failed!");
+    std::cout << "Compile-time tests passed: 4" << '\n';
+#endif
+
+    std::cout << "Testing 123456789012345678901234567890_big" << '\n';
+    assert(123456789012345678901234567890_big == bigint("123456789012345678901234567890") && "Literal test failed!");
+    std::cout << "Testing 1'000'000_big" << '\n';
+    assert(1'000'000_big == bigint(1000000) && "Literal with digit separators test failed!");
+
+    std::cout << "Literal tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Unit tests for lazily evaluated expressions built with `lazy()`.
+ *
+ * @return Exit code (0 for success, non-zero for failure).
+ */
+int8_t expression_test()
+{
+    std::ofstream logFile("./unit_test_expression.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << '\n';
+        EXIT_FAILURE;
+    }
+    std::string filename = "./data/unit_test_2data.txt";
+    std::ifstream input(filename);
+
+    if (!input.is_open())
+    {
+        std::cerr << "Error: Failed to open input file 'filename.txt'. Please check if the file exists and you have the necessary permissions." << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::string line;
+    uint64_t total_tests = 0;
+
+    while (std::getline(input, line))
+    {
+        std::istringstream string_stream(line);
+        std::string left, op, right, eq, result;
+        string_stream >> left >> op >> right >> eq >> result;
+        if (op != "+" && op != "-" && op != "*")
+            continue;
+
+        ++total_tests;
+        std::cout << "Testing lazy operation " << op << ": " << left << op << right << "=" << result << '\n';
+        bigint a(left);
+        bigint b(right);
+        bigint c(result);
+        bigint zero;
+
+        if (op == "+")
+        {
+            assert(bigint(lazy(a) + b) == c && "Lazy addition test a + b = c failed!");
+            assert(bigint(lazy(a) + b + c) == a + b + c && "Lazy addition test a + b + c failed!");
+            assert(bigint(lazy(a) - b + c) == a - b + c && "Lazy addition test a - b + c failed!");
+            assert(bigint(-lazy(b) + a + c) == -b + a + c && "Lazy addition test - b + a + c failed!");
+            assert(bigint(lazy(a) + (lazy(b) + c)) == (a + b) + c && "Lazy associativity test a + (b + c) failed!");
+            assert(bigint(lazy(a) - a) == zero && "Lazy inverse test a - a = 0 failed!");
+        }
+        else if (op == "-")
+        {
+            assert(bigint(lazy(a) - b) == c && "Lazy subtraction test a - b = c failed!");
+            assert(bigint(lazy(a) - b + b) == a && "Lazy inverse test a - b + b = a failed!");
+            assert(bigint(b - (lazy(a) - c)) == zero && "Lazy subtraction test b - (a - c) = 0 failed!");
+        }
+        else
+        {
+            assert(bigint(lazy(a) * b) == c && "Lazy multiplication test a * b = c failed!");
+            assert(bigint(lazy(a) * b - c) == zero && "Lazy multiply-subtract test a * b - c = 0 failed!");
+            assert(bigint(lazy(a) * b + a * (-lazy(b))) == zero && "Lazy multiply-add test a * b + a * (-b) = 0 failed!");
+            assert(bigint((lazy(a) + b) * (lazy(a) - b)) == a * a - b * b && "Lazy product of sums test failed!");
+        }
+    }
+
+    // products large enough for Karatsuba are built first and then added into the columns
+    bigint a = pow(bigint(7), 2400);
+    bigint b = pow(bigint(3), 4000);
+    bigint c = a * b;
+    std::cout << "Testing lazy products of 7^2400 and 3^4000" << '\n';
+    assert(bigint(lazy(a) * b) == c && "Lazy large multiplication test failed!");
+    assert(bigint(lazy(a) * b + a - c) == a && "Lazy large multiply-add test a * b + a - c = a failed!");
+    assert(bigint(lazy(a) * b + a * (-lazy(b))) == bigint(0) && "Lazy large multiply-add test a * b + a * (-b) = 0 failed!");
+    total_tests += 3;
+
+    input.close();
+    std::cout << "Lazy expression tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << '\n';
+    logFile.close();
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Unit tests for fused multiply-add, `sum` and `dot`.
+ *
+ * @return Exit code (0 for success, non-zero for failure).
+ */
+int8_t fma_test()
+{
+    std::ofstream logFile("./unit_test_fma.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << '\n';
+        EXIT_FAILURE;
+    }
+    std::string filename = "./data/unit_test_2data.txt";
+    std::ifstream input(filename);
+
+    if (!input.is_open())
+    {
+        std::cerr << "Error: Failed to open input file 'filename.txt'. Please check if the file exists and you have the necessary permissions." << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::string line;
+    uint64_t total_tests = 0;
+    std::vector<bigint> lefts;
+    std::vector<bigint> rights;
+    bigint expected_sum;
+    bigint expected_dot;
+
+    while (std::getline(input, line))
+    {
+        std::istringstream string_stream(line);
+        std::string left, op, right, eq, result;
+        string_stream >> left >> op >> right >> eq >> result;
+        if (op != "*")
+            continue;
+
+        ++total_tests;
+        std::cout << "Testing fused multiply-add: " << left << op << right << "=" << result << '\n';
+        bigint a(left);
+        bigint b(right);
+        bigint c(result);
+
+        bigint acc = c;
+        acc.submul(a, b);
+        assert(acc == bigint(0) && "Fused multiply-subtract test c - a * b = 0 failed!");
+        acc.addmul(a, b);
+        assert(acc == c && "Fused multiply-add test 0 + a * b = c failed!");
+        fma(acc, -a, b);
+        assert(acc == bigint(0) && "Fused multiply-add test c + (-a) * b = 0 failed!");
+        acc = a;
+        fma(acc, a, b);
+        assert(acc == a + c && "Fused multiply-add test a + a * b failed!");
+
+        lefts.push_back(a);
+        rights.push_back(b);
+        expected_sum += a;
+        expected_dot += c;
+    }
+
+    std::cout << "Testing sum and dot over " << lefts.size() << " terms" << '\n';
+    assert(sum(lefts) == expected_sum && "Sum test failed!");
+    assert(sum(std::vector<bigint>()) == bigint(0) && "Empty sum test failed!");
+    assert(dot(lefts, rights) == expected_dot && "Dot product test failed!");
+
+    bool exceptionThrown = false;
+    try
+    {
+        dot(lefts, std::vector<bigint>(1));
+    }
+    catch (const std::invalid_argument &e)
+    {
+        exceptionThrown = true;
+        std::cout << "Caught expected exception: " << e.what() << '\n';
+    }
+    assert(exceptionThrown && "Exception for ranges of different lengths not thrown!");
+
+    // the product is added into the accumulator's digits in place
+    bigint nines("99999999999999999999");
+    bigint power("100000000000000000000");
+    bigint acc = nines;
+    acc.addmul(bigint(1), bigint(1));
+    assert(acc == power && "In-place carry past the top digit test failed!");
+    acc.submul(bigint(1), bigint(1));
+    assert(acc == nines && "In-place borrow into the top digit test failed!");
+    acc = bigint(5);
+    acc.submul(bigint(3), bigint(4));
+    assert(acc == bigint(-7) && "In-place sign change test 5 - 3 * 4 failed!");
+    acc.addmul(bigint(-3), bigint(-4));
+    assert(acc == bigint(5) && "In-place sign change test -7 + 12 failed!");
+    acc = bigint(12);
+    acc.submul(bigint(3), bigint(4));
+    std::ostringstream printed;
+    printed << acc;
+    assert(acc == bigint(0) && !acc.get_is_negative() && printed.str() == "0" && "In-place cancellation test failed!");
+    acc = bigint();
+    acc.addmul(bigint(-3), bigint(4));
+    assert(acc == bigint(-12) && "In-place zero accumulator test failed!");
+    acc = bigint(7);
+    acc.addmul(acc, acc);
+    assert(acc == bigint(56) && "In-place aliased factors test failed!");
+    bigint long_acc = power * power + bigint(1);
+    acc = long_acc;
+    acc.addmul(nines, bigint(-9));
+    assert(acc == long_acc - nines * bigint(9) && "In-place short product test failed!");
+    bigint a = pow(bigint(7), 2400);
+    bigint b = pow(bigint(3), 4000);
+    acc = a;
+    acc.addmul(a, b);
+    assert(acc == a + a * b && "In-place Karatsuba product test failed!");
+    acc.submul(a, b);
+    assert(acc == a && "In-place Karatsuba product inverse test failed!");
+    total_tests += 10;
+
+    std::vector<int64_t> many(100000, std::numeric_limits<int64_t>::max());
+    assert(sum(many) == bigint(std::numeric_limits<int64_t>::max()) * bigint(100000) && "Sum of many terms test failed!");
+    total_tests += 4;
+
+    input.close();
+    std::cout << "Fused multiply-add tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << '\n';
+    logFile.close();
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Unit tests for `bigint_accumulator`, including per-thread partial sums.
+ *
+ */
+void accumulator_test()
+{
+    std::ofstream logFile("./unit_test_accumulator.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 5;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+    std::uniform_int_distribution<int64_t> dist(std::numeric_limits<int64_t>::min() + 1, std::numeric_limits<int64_t>::max());
+
+    std::vector<int64_t> values(40000);
+    for (int64_t &value : values)
+    {
+        value = dist(mt64);
+    }
+    bigint expected;
+    for (int64_t value : values)
+    {
+        expected += bigint(value);
+    }
+
+    std::cout << "Testing sequential accumulation of " << values.size() << " values" << '\n';
+    bigint_accumulator sequential;
+    for (int64_t value : values)
+    {
+        sequential += value;
+    }
+    assert(sequential.to_bigint() == expected && "Sequential accumulation test failed!");
+
+    std::cout << "Testing accumulation merged from 4 threads" << '\n';
+    std::vector<bigint_accumulator> partials(4);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < partials.size(); t++)
+    {
+        workers.emplace_back([&values, &partials, t]()
+                             {
+            for (size_t i = t; i < values.size(); i += 4)
+            {
+                partials[t] += values[i];
+            } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    bigint_accumulator merged;
+    for (const bigint_accumulator &partial : partials)
+    {
+        merged += partial;
+    }
+    assert(merged.to_bigint() == expected && "Merged accumulation test failed!");
+
+    std::cout << "Testing subtraction of every value" << '\n';
+    for (int64_t value : values)
+    {
+        merged -= value;
+    }
+    assert(merged.to_bigint() == bigint(0) && "Accumulation inverse test failed!");
+
+    std::cout << "Testing accumulation of bigints" << '\n';
+    bigint big("-123456789012345678901234567890123456789");
+    bigint_accumulator mixed;
+    mixed += big;
+    mixed += std::numeric_limits<int64_t>::max();
+    mixed -= big;
+    mixed -= big;
+    mixed -= std::numeric_limits<int64_t>::min();
+    assert(mixed.to_bigint() == bigint(std::numeric_limits<int64_t>::max()) * bigint(2) + bigint(1) - big && "Bigint accumulation test failed!");
+
+    std::cout << "Testing empty accumulator" << '\n';
+    assert(bigint_accumulator().to_bigint() == bigint(0) && "Empty accumulator test failed!");
+
+    std::cout << "Accumulator tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Unit tests for `square()` and `pow()`.
+ *
+ * @return Exit code (0 for success, non-zero for failure).
+ */
+int8_t pow_test()
+{
+    std::ofstream logFile("./unit_test_pow.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << '\n';
+        EXIT_FAILURE;
+    }
+    std::string filename = "./data/unit_test_2data.txt";
+    std::ifstream input(filename);
+
+    if (!input.is_open())
+    {
+        std::cerr << "Error: Failed to open input file 'filename.txt'. Please check if the file exists and you have the necessary permissions." << '\n';
+        return EXIT_FAILURE;
+    }
+
+    std::string line;
+    uint64_t total_tests = 0;
+
+    while (std::getline(input, line))
+    {
+        std::istringstream string_stream(line);
+        std::string left, op, right, eq, result;
+        string_stream >> left >> op >> right >> eq >> result;
+        if (op != "*")
+            continue;
+
+        ++total_tests;
+        bigint a(left);
+        std::cout << "Testing square and pow of " << left << '\n';
+        assert(a.square() == a * a && "Square test a.square() = a * a failed!");
+        assert(pow(a, 0) == bigint(1) && "Power test a^0 = 1 failed!");
+        assert(pow(a, 1) == a && "Power test a^1 = a failed!");
+        assert(pow(a, 2) == a * a && "Power test a^2 = a * a failed!");
+        assert(pow(a, 5) == a * a * a * a * a && "Power test a^5 failed!");
+        assert(pow(a, 13) == pow(a, 6) * pow(a, 7) && "Power test a^13 = a^6 * a^7 failed!");
+    }
+
+    std::cout << "Testing powers of ten and trailing zeros" << '\n';
+    assert(pow(bigint(10), 30) == bigint("1000000000000000000000000000000") && "Power test 10^30 failed!");
+    assert(pow(bigint(-200), 3) == bigint(-8000000) && "Power test (-200)^3 failed!");
+    assert(pow(bigint(-1), 1000001) == bigint(-1) && "Power test (-1)^odd failed!");
+    assert(pow(bigint(0), 0) == bigint(1) && "Power test 0^0 failed!");
+    assert(pow(bigint(0), 7) == bigint(0) && "Power test 0^7 failed!");
+
+    std::cout << "Testing long exponents" << '\n';
+    bigint expected(1);
+    bigint two(2);
+    for (uint64_t i = 0; i < 3000; i++)
+    {
+        expected *= two;
+    }
+    assert(pow(two, 3000) == expected && "Power test 2^3000 failed!");
+    assert(pow(expected, 3) == expected.square() * expected && "Karatsuba square test failed!");
+    // a 301-digit base with a 3-bit window, so the table and the window products use Karatsuba
+    bigint large_base = pow(bigint(10), 300) + bigint(7);
+    assert(pow(large_base, 259) == pow(large_base.square(), 129) * large_base && "Power test with a large base failed!");
+    total_tests += 8;
+
+    input.close();
+    std::cout << "Power tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << '\n';
+    logFile.close();
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Unit tests for `modular_context` Montgomery arithmetic.
+ *
+ */
+void modular_test()
+{
+    std::ofstream logFile("./unit_test_modular.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing word-sized modulus against native arithmetic" << '\n';
+    const int64_t small_modulus = 1000003;
+    bigint word_modulus(small_modulus);
+    modular_context word_context(word_modulus);
+    std::uniform_int_distribution<int64_t> dist(-4000000000, 4000000000);
+    for (uint64_t i = 0; i < 200; i++)
+    {
+        int64_t a = dist(mt64);
+        int64_t b = dist(mt64);
+        int64_t a_mod = (a % small_modulus + small_modulus) % small_modulus;
+        int64_t b_mod = (b % small_modulus + small_modulus) % small_modulus;
+        int64_t exponent = std::abs(dist(mt64)) % 1000;
+        int64_t expected_pow = 1;
+        for (int64_t e = 0; e < exponent; e++)
+        {
+            expected_pow = expected_pow * a_mod % small_modulus;
+        }
+
+        assert(word_context.from_montgomery(word_context.to_montgomery(bigint(a))) == bigint(a_mod) && "Montgomery round trip test failed!");
+        assert(word_context.from_montgomery(word_context.mulmod(word_context.to_montgomery(bigint(a)), word_context.to_montgomery(bigint(b)))) == bigint(a_mod * b_mod % small_modulus) && "Montgomery multiplication test failed!");
+        assert(word_context.from_montgomery(word_context.sqrmod(word_context.to_montgomery(bigint(a)))) == bigint(a_mod * a_mod % small_modulus) && "Montgomery squaring test failed!");
+        assert(word_context.powmod(bigint(a), bigint(exponent)) == bigint(expected_pow) && "Modular exponentiation test failed!");
+        assert(word_context.powmod(bigint(a), bigint(exponent), true) == bigint(expected_pow) && "Constant-time modular exponentiation test failed!");
+        total_tests += 5;
+    }
+
+    std::cout << "Testing Fermat's little theorem for Mersenne primes" << '\n';
+    for (uint64_t exponent : {61, 127, 521})
+    {
+        bigint prime = pow(bigint(2), exponent) - bigint(1);
+        modular_context context(prime);
+        std::cout << "Testing modulus 2^" << exponent << " - 1" << '\n';
+        assert(context.powmod(bigint(3), prime - bigint(1)) == bigint(1) && "Fermat test failed!");
+        assert(context.powmod(bigint(3), prime - bigint(1), true) == bigint(1) && "Constant-time Fermat test failed!");
+        assert(context.powmod(bigint(-5), prime) == prime - bigint(5) && "Fermat test with negative base failed!");
+        total_tests += 3;
+    }
+
+    std::cout << "Testing exponent laws modulo a large odd modulus" << '\n';
+    bigint modulus = pow(bigint(3), 400) + bigint(2);
+    modular_context context(modulus);
+    bigint base("123456789012345678901234567890");
+    bigint e1("98765432109876543210");
+    bigint e2("1234567890123456789");
+    bigint lhs = context.powmod(base, e1 + e2);
+    bigint rhs = context.from_montgomery(context.mulmod(context.to_montgomery(context.powmod(base, e1)), context.to_montgomery(context.powmod(base, e2))));
+    assert(lhs == rhs && "Exponent law test failed!");
+    assert(context.powmod(base, bigint(0)) == bigint(1) && "Zero exponent test failed!");
+    total_tests += 2;
+
+    std::cout << "Testing invalid arguments" << '\n';
+    for (const bigint &bad : {bigint(0), bigint(-7), bigint(1000), bigint(15)})
+    {
+        bool exceptionThrown = false;
+        try
+        {
+            modular_context bad_context(bad);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            exceptionThrown = true;
+            std::cout << "Caught expected exception: " << e.what() << '\n';
+        }
+        assert(exceptionThrown && "Exception for invalid modulus not thrown!");
+        total_tests++;
+    }
+    bool exceptionThrown = false;
+    try
+    {
+        context.powmod(base, bigint(-1));
+    }
+    catch (const std::invalid_argument &e)
+    {
+        exceptionThrown = true;
+        std::cout << "Caught expected exception: " << e.what() << '\n';
+    }
+    assert(exceptionThrown && "Exception for negative exponent not thrown!");
+    total_tests++;
+
+    std::cout << "Modular tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests bigint_divisor against the division identity and native arithmetic.
+ *
+ * Logs results to "unit_test_divisor.log".
+ */
+void divisor_test()
+{
+    std::ofstream logFile("./unit_test_divisor.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing word-sized operands against native arithmetic" << '\n';
+    std::uniform_int_distribution<int64_t> dist(-4000000000000000000, 4000000000000000000);
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        int64_t a = dist(mt64);
+        int64_t d = dist(mt64) >> (mt64() % 63);
+        if (d == 0)
+        {
+            d = 1;
+        }
+        bigint_divisor divisor{bigint(d)};
+        std::pair<bigint, bigint> qr = divisor.divmod(bigint(a));
+        assert(qr.first == bigint(a / d) && "Quotient test failed!");
+        assert(qr.second == bigint(a % d) && "Remainder test failed!");
+        assert(divisor.div(bigint(a)) == bigint(a / d) && "div test failed!");
+        assert(divisor.mod(bigint(a)) == bigint(a % d) && "mod test failed!");
+        assert(divisible_by(bigint(a), divisor) == (a % d == 0) && "divisible_by test failed!");
+        total_tests += 5;
+    }
+
+    std::cout << "Testing the division identity for multi-limb operands" << '\n';
+    for (uint64_t i = 0; i < 300; i++)
+    {
+        bigint d = bigint(dist(mt64));
+        for (uint64_t j = mt64() % 6; j > 0; j--)
+        {
+            d = d * bigint(dist(mt64)) + bigint(dist(mt64));
+        }
+        if (d == bigint(0))
+        {
+            d = bigint(7);
+        }
+        bigint q = bigint(dist(mt64));
+        for (uint64_t j = mt64() % 6; j > 0; j--)
+        {
+            q = q * bigint(dist(mt64));
+        }
+        bigint_divisor divisor(d);
+        bigint a = q * d;
+        assert(divisor.div(a) == q && "Exact quotient test failed!");
+        assert(divisor.mod(a) == bigint(0) && "Exact remainder test failed!");
+        assert(divisible_by(a, divisor) && "divisible_by for a multiple failed!");
+
+        bigint b = a + bigint(dist(mt64));
+        std::pair<bigint, bigint> qr = divisor.divmod(b);
+        assert(qr.first * d + qr.second == b && "Division identity test failed!");
+        assert(qr.second.abs() < d.abs() && "Remainder bound test failed!");
+        assert((qr.second == bigint(0) || qr.second.get_is_negative() == b.get_is_negative()) && "Remainder sign test failed!");
+        total_tests += 6;
+    }
+
+    std::cout << "Testing divisors with last-digit fast paths" << '\n';
+    for (int64_t d : {1, -1, 2, -2, 5, -5, 10, -10})
+    {
+        bigint_divisor divisor{bigint(d)};
+        for (int64_t a : {0, 1, -1, 4, 5, 15, 20, -30, 123456789})
+        {
+            assert(divisible_by(bigint(a), divisor) == (a % d == 0) && "Fast path divisible_by test failed!");
+            assert(divisor.mod(bigint(a)) == bigint(a % d) && "Fast path mod test failed!");
+            total_tests += 2;
+        }
+    }
+
+    std::cout << "Testing division by zero" << '\n';
+    bool exceptionThrown = false;
+    try
+    {
+        bigint_divisor zero{bigint(0)};
+    }
+    catch (const std::invalid_argument &e)
+    {
+        exceptionThrown = true;
+        std::cout << "Caught expected exception: " << e.what() << '\n';
+    }
+    assert(exceptionThrown && "Exception for division by zero not thrown!");
+    total_tests++;
+
+    std::cout << "Divisor tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests gcd, lcm, gcdext and invmod against native arithmetic and their defining identities.
+ *
+ * Logs results to "unit_test_gcd.log".
+ */
+void gcd_test()
+{
+    std::ofstream logFile("./unit_test_gcd.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing word-sized operands against std::gcd" << '\n';
+    std::uniform_int_distribution<int64_t> dist(-4000000000000000000, 4000000000000000000);
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        int64_t common = (dist(mt64) >> 40) | 1;
+        int64_t a = (dist(mt64) >> (mt64() % 63)) / common * common;
+        int64_t b = (dist(mt64) >> (mt64() % 63)) / common * common;
+        assert(gcd(bigint(a), bigint(b)) == bigint(std::gcd(a, b)) && "Word-sized gcd test failed!");
+        std::tuple<bigint, bigint, bigint> result = gcdext(bigint(a), bigint(b));
+        assert(std::get<0>(result) == bigint(std::gcd(a, b)) && "Word-sized gcdext test failed!");
+        assert(bigint(a) * std::get<1>(result) + bigint(b) * std::get<2>(result) == std::get<0>(result) && "Word-sized Bezout identity test failed!");
+        total_tests += 3;
+    }
+
+    std::cout << "Testing multi-limb operands with a known common factor" << '\n';
+    for (uint64_t i = 0; i < 200; i++)
+    {
+        bigint common = bigint(dist(mt64)).abs() + bigint(1);
+        bigint a = bigint(dist(mt64));
+        bigint b = bigint(dist(mt64));
+        for (uint64_t j = mt64() % 8; j > 0; j--)
+        {
+            a = a * bigint(dist(mt64));
+        }
+        for (uint64_t j = mt64() % 8; j > 0; j--)
+        {
+            b = b * bigint(dist(mt64));
+        }
+        bigint g = gcd(a, b);
+        assert(gcd(a * common, b * common) == g * common && "Scaled gcd test failed!");
+        assert(gcd(a, b) == gcd(b, a) && "gcd symmetry test failed!");
+
+        std::tuple<bigint, bigint, bigint> result = gcdext(a * common, b);
+        bigint bezout = a * common * std::get<1>(result) + b * std::get<2>(result);
+        assert(bezout == std::get<0>(result) && "Bezout identity test failed!");
+        assert(std::get<1>(result).abs() <= b.abs() && "Bezout coefficient bound test failed!");
+
+        assert(lcm(a, b) * g == (a * b).abs() && "lcm test failed!");
+        total_tests += 5;
+    }
+
+    std::cout << "Testing modular inverses" << '\n';
+    bigint prime = pow(bigint(2), 127) - bigint(1);
+    for (uint64_t i = 0; i < 200; i++)
+    {
+        bigint a = bigint(dist(mt64)) * bigint(dist(mt64)) * bigint(dist(mt64));
+        if (bigint_divisor(prime).mod(a) == bigint(0))
+        {
+            continue;
+        }
+        bigint inverse = invmod(a, prime);
+        assert(inverse >= bigint(0) && inverse < prime && "Inverse range test failed!");
+        assert(bigint_divisor(prime).mod(a * inverse - bigint(1)) == bigint(0) && "Inverse test failed!");
+        total_tests += 2;
+    }
+    assert(invmod(bigint(3), bigint(10)) == bigint(7) && "Small inverse test failed!");
+    assert(invmod(bigint(-3), bigint(10)) == bigint(3) && "Negative inverse test failed!");
+    assert(invmod(bigint(5), bigint(1)) == bigint(0) && "Inverse modulo 1 test failed!");
+    assert(gcd(bigint(0), bigint(0)) == bigint(0) && "gcd(0, 0) test failed!");
+    assert(gcd(bigint(0), bigint(-12)) == bigint(12) && "gcd(0, b) test failed!");
+    assert(lcm(bigint(0), bigint(12)) == bigint(0) && "lcm(0, b) test failed!");
+    total_tests += 6;
+
+    std::cout << "Testing invalid arguments" << '\n';
+    for (const std::pair<bigint, bigint> &bad : {std::make_pair(bigint(3), bigint(0)), std::make_pair(bigint(3), bigint(-7)), std::make_pair(bigint(4), bigint(10))})
+    {
+        bool exceptionThrown = false;
+        try
+        {
+            invmod(bad.first, bad.second);
+        }
+        catch (const std::invalid_argument &e)
+        {
+            exceptionThrown = true;
+            std::cout << "Caught expected exception: " << e.what() << '\n';
+        }
+        assert(exceptionThrown && "Exception for invalid inverse not thrown!");
+        total_tests++;
+    }
+
+    std::cout << "GCD tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests integer roots and the perfect square and perfect power predicates.
+ *
+ * Logs results to "unit_test_root.log".
+ */
+void root_test()
+{
+    std::ofstream logFile("./unit_test_root.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+    std::uniform_int_distribution<int64_t> dist(1, 4000000000000000000);
+
+    std::cout << "Testing roots of random operands" << '\n';
+    for (uint64_t i = 0; i < 300; i++)
+    {
+        bigint n = bigint(dist(mt64));
+        for (uint64_t j = mt64() % 8; j > 0; j--)
+        {
+            n = n * bigint(dist(mt64));
+        }
+        uint64_t k = 1 + mt64() % 12;
+        bigint root = iroot(n, k);
+        assert(pow(root, k) <= n && pow(root + bigint(1), k) > n && "iroot bound test failed!");
+        if (k % 2 == 1)
+        {
+            assert(iroot(-n, k) == -root && "Odd root of a negative number test failed!");
+            total_tests++;
+        }
+
+        std::pair<bigint, bigint> sr = isqrt_rem(n);
+        assert(sr.first == isqrt(n) && "isqrt test failed!");
+        assert(sr.first.square() + sr.second == n && "isqrt_rem identity test failed!");
+        assert(sr.second >= bigint(0) && sr.second <= sr.first + sr.first && "isqrt_rem remainder bound test failed!");
+        total_tests += 4;
+    }
+
+    std::cout << "Testing perfect squares and powers" << '\n';
+    for (uint64_t i = 0; i < 200; i++)
+    {
+        bigint m = bigint(dist(mt64)) * bigint(dist(mt64)) + bigint(2);
+        uint64_t e = 2 + mt64() % 6;
+        assert(is_perfect_square(m.square()) && "Perfect square test failed!");
+        assert(!is_perfect_square(m.square() + bigint(1)) && "Non-square test failed!");
+        assert(!is_perfect_square(-m.square()) && "Negative square test failed!");
+        assert(is_perfect_power(pow(m, e)) && "Perfect power test failed!");
+        assert(iroot(pow(m, e), e) == m && "Exact root test failed!");
+        total_tests += 5;
+        if (e % 2 == 1)
+        {
+            assert(is_perfect_power(-pow(m, e)) && "Negative perfect power test failed!");
+            total_tests++;
+        }
+    }
+
+    std::cout << "Testing predicates against brute force" << '\n';
+    for (uint64_t v = 0; v < 5000; v++)
+    {
+        bool square = false;
+        bool power = v <= 1;
+        for (uint64_t b = 2; b * b <= v; b++)
+        {
+            uint64_t p = b * b;
+            while (p < v)
+            {
+                p *= b;
+            }
+            power = power || p == v;
+        }
+        for (uint64_t b = 0; b * b <= v; b++)
+        {
+            square = square || b * b == v;
+        }
+        assert(is_perfect_square(bigint(v)) == square && "Brute force perfect square test failed!");
+        assert(is_perfect_power(bigint(v)) == power && "Brute force perfect power test failed!");
+        total_tests += 2;
+    }
+    assert(is_perfect_power(bigint(-8)) && !is_perfect_power(bigint(-4)) && "Negative perfect power test failed!");
+    total_tests++;
+
+    std::cout << "Testing invalid arguments" << '\n';
+    for (int64_t k : {0, 2})
+    {
+        bool exceptionThrown = false;
+        try
+        {
+            iroot(bigint(-16), static_cast<uint64_t>(k));
+        }
+        catch (const std::invalid_argument &e)
+        {
+            exceptionThrown = true;
+            std::cout << "Caught expected exception: " << e.what() << '\n';
+        }
+        assert(exceptionThrown && "Exception for invalid root not thrown!");
+        total_tests++;
+    }
+    bool exceptionThrown = false;
+    try
+    {
+        isqrt(bigint(-1));
+    }
+    catch (const std::invalid_argument &e)
+    {
+        exceptionThrown = true;
+        std::cout << "Caught expected exception: " << e.what() << '\n';
+    }
+    assert(exceptionThrown && "Exception for negative square root not thrown!");
+    total_tests++;
+
+    std::cout << "Root tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests is_probable_prime and next_prime against a sieve and known pseudoprimes.
+ *
+ * Logs results to "unit_test_prime.log".
+ */
+void prime_test()
+{
+    std::ofstream logFile("./unit_test_prime.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+
+    std::cout << "Testing small values against a sieve" << '\n';
+    const uint64_t limit = 100000;
+    std::vector<bool> composite(limit, false);
+    composite[0] = composite[1] = true;
+    for (uint64_t p = 2; p * p < limit; p++)
+    {
+        for (uint64_t m = p * p; !composite[p] && m < limit; m += p)
+        {
+            composite[m] = true;
+        }
+    }
+    for (uint64_t v = 0; v < limit; v++)
+    {
+        assert(is_probable_prime(bigint(v)) == !composite[v] && "Small primality test failed!");
+        total_tests++;
+    }
+    for (uint64_t v = 0; v + 1 < limit / 2; v += 97)
+    {
+        uint64_t next = v + 1;
+        while (composite[next])
+        {
+            next++;
+        }
+        assert(next_prime(bigint(v)) == bigint(next) && "Small next_prime test failed!");
+        total_tests++;
+    }
+    assert(!is_probable_prime(bigint(-7)) && "Negative primality test failed!");
+    total_tests++;
+
+    std::cout << "Testing strong pseudoprimes and Carmichael numbers" << '\n';
+    for (const char *pseudoprime : {"2047", "1373653", "25326001", "3215031751", "2152302898747", "3474749660383", "341550071728321", "3825123056546413051", "318665857834031151167461", "3317044064679887385961981", "5459", "5777", "10877", "16109", "18971", "561", "41041", "825265", "321197185"})
+    {
+        assert(!is_probable_prime(bigint(pseudoprime)) && "Pseudoprime test failed!");
+        assert(!is_probable_prime(bigint(pseudoprime), 4) && "Pseudoprime test with extra rounds failed!");
+        total_tests += 2;
+    }
+
+    std::cout << "Testing large primes and composites" << '\n';
+    for (uint64_t exponent : {61, 89, 107, 127, 521, 607})
+    {
+        bigint mersenne = pow(bigint(2), exponent) - bigint(1);
+        assert(is_probable_prime(mersenne) && "Mersenne prime test failed!");
+        assert(is_probable_prime(mersenne, 3) && "Mersenne prime test with extra rounds failed!");
+        assert(!is_probable_prime(mersenne * mersenne) && "Square of a prime test failed!");
+        assert(!is_probable_prime(pow(bigint(2), exponent + 2) - bigint(1)) && "Mersenne composite test failed!");
+        total_tests += 4;
+    }
+    bigint p = next_prime(pow(bigint(10), 100));
+    assert(p == pow(bigint(10), 100) + bigint(267) && "Large next_prime test failed!");
+    bigint q = next_prime(p);
+    assert(q == pow(bigint(10), 100) + bigint(949) && "Consecutive next_prime test failed!");
+    assert(!is_probable_prime(p * q) && "Semiprime test failed!");
+    total_tests += 3;
+
+    std::cout << "Prime tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests shifts and bitwise operators against native two's-complement arithmetic.
+ *
+ * Logs results to "unit_test_bitwise.log".
+ */
+void bitwise_test()
+{
+    std::ofstream logFile("./unit_test_bitwise.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing word-sized operands against int64_t" << '\n';
+    for (uint64_t i = 0; i < 5000; i++)
+    {
+        int64_t a = static_cast<int64_t>(mt64()) >> (mt64() % 63);
+        int64_t b = static_cast<int64_t>(mt64()) >> (mt64() % 63);
+        uint64_t k = mt64() % 64;
+        assert((bigint(a) & bigint(b)) == bigint(a & b) && "AND test failed!");
+        assert((bigint(a) | bigint(b)) == bigint(a | b) && "OR test failed!");
+        assert((bigint(a) ^ bigint(b)) == bigint(a ^ b) && "XOR test failed!");
+        assert(~bigint(a) == bigint(~a) && "NOT test failed!");
+        assert((bigint(a) >> k) == bigint(a >> k) && "Right shift test failed!");
+        assert((bigint(a >> 32) << (k % 31)) == bigint((a >> 32) * (int64_t(1) << (k % 31))) && "Left shift test failed!");
+        assert(bigint(a).test_bit(k) == ((a >> k & 1) != 0) && "test_bit test failed!");
+
+        bigint c(a);
+        bool value = mt64() % 2 == 0;
+        c.set_bit(k % 63, value);
+        int64_t expected = value ? a | (int64_t(1) << (k % 63)) : a & ~(int64_t(1) << (k % 63));
+        assert(c == bigint(expected) && "set_bit test failed!");
+
+        uint64_t magnitude = a < 0 ? 0 - static_cast<uint64_t>(a) : static_cast<uint64_t>(a);
+        uint64_t length = 0;
+        uint64_t ones = 0;
+        for (uint64_t m = magnitude; m != 0; m >>= 1)
+        {
+            length++;
+            ones += m & 1;
+        }
+        assert(bigint(a).bit_length() == length && "bit_length test failed!");
+        assert(bigint(a).popcount() == ones && "popcount test failed!");
+        total_tests += 10;
+    }
+
+    std::cout << "Testing multi-word operands against arithmetic identities" << '\n';
+    for (uint64_t i = 0; i < 300; i++)
+    {
+        bigint x = pow(bigint(3), mt64() % 400);
+        bigint y = pow(bigint(7), mt64() % 300);
+        if (mt64() % 2)
+            x = -x;
+        if (mt64() % 2)
+            y = -y;
+        uint64_t k = mt64() % 700;
+        bigint scale = pow(bigint(2), k);
+        assert((x << k) == x * scale && "Multi-word left shift test failed!");
+        assert(((x << k) >> k) == x && "Shift round trip test failed!");
+        assert((x >> k) * scale + (x - ((x >> k) << k)) == x && "Floor right shift test failed!");
+        assert((x & y) + (x | y) == x + y && "AND/OR identity test failed!");
+        assert((x ^ y) == (x | y) - (x & y) && "XOR identity test failed!");
+        assert((x & ~x) == bigint(0) && (x | ~x) == bigint(-1) && "Complement identity test failed!");
+        assert(x.abs().bit_length() == (x.abs() << k).bit_length() - (x == bigint(0) ? 0 : k) && "Multi-word bit_length test failed!");
+        assert(scale.popcount() == 1 && scale.bit_length() == k + 1 && scale.test_bit(k) && !scale.test_bit(k + 1) && "Power of two test failed!");
+        assert((-scale).test_bit(k) && (k == 0 || !(-scale).test_bit(k - 1)) && (-scale).test_bit(k + 100) && "Negative test_bit test failed!");
+        total_tests += 9;
+    }
+    assert((bigint(-1) >> 1000) == bigint(-1) && "Right shift of -1 test failed!");
+    assert((bigint(0) << 1000) == bigint(0) && bigint(0).bit_length() == 0 && "Zero shift test failed!");
+    total_tests += 2;
+
+    std::cout << "Bitwise tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests value semantics of copies and moves, including copies shared across threads.
+ *
+ * Runs against plain storage by default and copy-on-write storage with `-DBIGINT_SHARED_STORAGE`.
+ * Logs results to "unit_test_storage.log".
+ */
+void storage_test()
+{
+    std::ofstream logFile("./unit_test_storage.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    const bigint constant = pow(bigint(3), 5000);
+    const bigint expected = constant + bigint(1);
+
+    std::cout << "Testing that mutating a copy leaves the original intact" << '\n';
+    std::vector<bigint> copies(50, constant);
+    for (size_t i = 0; i < copies.size(); i++)
+    {
+        assert(copies[i] == constant && "Copy test failed!");
+        switch (i % 5)
+        {
+        case 0:
+            copies[i] += bigint(1);
+            break;
+        case 1:
+            copies[i] = copies[i] * bigint(2);
+            break;
+        case 2:
+            copies[i].set_bit(0, false);
+            break;
+        case 3:
+            copies[i] = -copies[i];
+            break;
+        default:
+            copies[i] = copies[i - 1];
+            break;
+        }
+        assert(constant + bigint(1) == expected && "Original modified through a copy!");
+        total_tests += 2;
+    }
+    assert(copies[0] == expected && copies[1] == constant * bigint(2) && copies[3] == -constant && copies[4] == copies[3] && "Mutated copy test failed!");
+    total_tests++;
+
+    std::cout << "Testing moves" << '\n';
+    bigint source = constant;
+    bigint moved = std::move(source);
+    assert(moved == constant && source == bigint(0) && "Move constructor test failed!");
+    // a moved-from value keeps no digits, which read as 0: it prints, hashes and computes like bigint(0)
+    std::ostringstream printed;
+    printed << source;
+    assert(printed.str() == "0" && source.get_digits() == bigint(0).get_digits() && source.hash64() == bigint(0).hash64() && "Moved-from value test failed!");
+    assert(source + bigint(5) == bigint(5) && source * constant == bigint(0) && source < bigint(1) && !(source < bigint(0)) && "Moved-from arithmetic test failed!");
+    source = std::move(moved);
+    assert(source == constant && moved == bigint(0) && "Move assignment test failed!");
+    printed.str("");
+    printed << moved;
+    assert(printed.str() == "0" && moved.get_digits() == bigint(0).get_digits() && std::hash<bigint>()(moved) == std::hash<bigint>()(bigint(0)) && "Moved-from assignment test failed!");
+    bigint copied = moved;
+    copied.addmul(constant, bigint(2));
+    assert(copied == constant * bigint(2) && "Copy of a moved-from value test failed!");
+    moved = bigint(7);
+    assert(moved == bigint(7) && "Assignment after move test failed!");
+    total_tests += 7;
+
+    std::cout << "Testing copies of a shared constant across threads" << '\n';
+    std::vector<std::thread> threads;
+    std::vector<int> results(4, 0);
+    for (size_t t = 0; t < results.size(); t++)
+    {
+        threads.emplace_back([&constant, &expected, &results, t]()
+                             {
+                                 bool ok = true;
+                                 for (int64_t i = 0; i < 200; i++)
+                                 {
+                                     bigint copy = constant;
+                                     std::vector<bigint> held(4, copy);
+                                     copy += bigint(i);
+                                     ok = ok && copy - bigint(i) == constant && held[3] == constant && constant + bigint(1) == expected;
+                                 }
+                                 results[t] = ok ? 1 : 0; });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    for (int result : results)
+    {
+        assert(result == 1 && "Threaded copy test failed!");
+        total_tests++;
+    }
+
+    std::cout << "Storage tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests bigint_batch kernels against the scalar operators, single-threaded and threaded.
+ *
+ * Logs results to "unit_test_batch.log".
+ */
+void batch_test()
+{
+    std::ofstream logFile("./unit_test_batch.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+    auto random_bigint = [&mt64](size_t max_digits)
+    {
+        std::string s = mt64() % 2 ? "-" : "";
+        size_t len = 1 + mt64() % max_digits;
+        s += static_cast<char>('1' + mt64() % 9);
+        for (size_t i = 1; i < len; i++)
+        {
+            s += static_cast<char>('0' + mt64() % 10);
+        }
+        return mt64() % 16 == 0 ? bigint(0) : bigint(s);
+    };
+
+    for (size_t round = 0; round < 20; round++)
+    {
+        size_t count = 1 + mt64() % 200;
+        size_t threads = 1 + round % 4;
+        std::vector<bigint> a(count);
+        std::vector<bigint> b(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            a[i] = random_bigint(80);
+            b[i] = mt64() % 8 == 0 ? a[i] : random_bigint(80);
+        }
+        bigint m = random_bigint(40).abs() + bigint(1);
+        if (round % 5 == 0)
+            m = bigint(static_cast<int64_t>(1 + mt64() % 1000000000));
+
+        std::cout << "Testing " << count << " values on " << threads << " threads" << '\n';
+        bigint_batch x(a);
+        bigint_batch y(b);
+        std::vector<bigint> round_trip = x.to_vector();
+        std::vector<bigint> sum = x.add(y, threads).to_vector();
+        std::vector<bigint> difference = x.sub(y, threads).to_vector();
+        std::vector<bigint> product = x.mul(y, threads).to_vector();
+        std::vector<int> order = x.compare(y, threads);
+        std::vector<bigint> residue = x.mod(m, threads).to_vector();
+        bigint_divisor reducer(m);
+        for (size_t i = 0; i < count; i++)
+        {
+            assert(round_trip[i] == a[i] && "Round trip test failed!");
+            assert(sum[i] == a[i] + b[i] && "Batch add test failed!");
+            assert(difference[i] == a[i] - b[i] && "Batch sub test failed!");
+            assert(product[i] == a[i] * b[i] && "Batch mul test failed!");
+            assert(order[i] == (a[i] < b[i] ? -1 : a[i] == b[i] ? 0 : 1) && "Batch compare test failed!");
+            assert(residue[i] == reducer.mod(reducer.mod(a[i]) + m) && "Batch mod test failed!");
+            total_tests += 6;
+        }
+    }
+
+    std::cout << "Testing width limits" << '\n';
+    bigint_batch narrow(2, 1);
+    narrow.set(0, bigint(499999999));
+    narrow.set(1, bigint(-500000000));
+    assert(narrow.get(0) == bigint(499999999) && narrow.get(1) == bigint(-500000000) && "Width limit test failed!");
+    bool thrown = false;
+    try
+    {
+        narrow.set(0, bigint(500000000));
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "Width overflow test failed!");
+    total_tests += 2;
+
+    std::cout << "Batch tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests Karatsuba multiplication, product trees, factorials and binomial coefficients.
+ *
+ * Logs results to "unit_test_combinatorics.log".
+ */
+void combinatorics_test()
+{
+    std::ofstream logFile("./unit_test_combinatorics.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing Karatsuba multiplication against squares" << '\n';
+    for (uint64_t i = 0; i < 40; i++)
+    {
+        bigint a = pow(bigint(3), 100 + mt64() % 3000);
+        bigint b = pow(bigint(7), 100 + mt64() % 2000);
+        if (mt64() % 2)
+            a = -a;
+        if (mt64() % 2)
+            b = -b;
+        assert((a + b).square() - (a - b).square() == a * b * bigint(4) && "Karatsuba product test failed!");
+        assert(a * b == b * a && "Karatsuba commutativity test failed!");
+        total_tests += 2;
+    }
+
+    std::cout << "Testing factorials against running products" << '\n';
+    bigint running(1);
+    for (uint64_t n = 0; n <= 400; n++)
+    {
+        if (n > 0)
+            running *= bigint(static_cast<int64_t>(n));
+        assert(factorial(n) == running && "Factorial test failed!");
+        total_tests++;
+    }
+    assert(factorial(3000, 4) == factorial(3000) && "Threaded factorial test failed!");
+    total_tests++;
+
+    std::cout << "Testing binomial coefficients against Pascal's triangle" << '\n';
+    std::vector<bigint> row(1, bigint(1));
+    for (uint64_t n = 0; n <= 150; n++)
+    {
+        for (uint64_t k = 0; k <= n + 1; k++)
+        {
+            assert(binomial(n, k) == (k <= n ? row[k] : bigint(0)) && "Binomial test failed!");
+            total_tests++;
+        }
+        std::vector<bigint> next(n + 2, bigint(1));
+        for (uint64_t k = 1; k <= n; k++)
+        {
+            next[k] = row[k - 1] + row[k];
+        }
+        row = next;
+    }
+    assert(binomial(2000, 700, 3) == binomial(2000, 1300) && "Threaded binomial test failed!");
+    bigint large(1000000000000);
+    assert(binomial(1000000000000, 3) == bigint_divisor(bigint(6)).div(large * (large - bigint(1)) * (large - bigint(2))) && "Large binomial test failed!");
+    total_tests += 2;
+
+    std::cout << "Testing product trees" << '\n';
+    for (uint64_t i = 0; i < 20; i++)
+    {
+        std::vector<bigint> factors;
+        std::list<bigint> listed;
+        bigint expected(1);
+        size_t count = mt64() % 100;
+        for (size_t j = 0; j < count; j++)
+        {
+            bigint factor = pow(bigint(static_cast<int64_t>(2 + mt64() % 1000)), mt64() % 30);
+            if (mt64() % 4 == 0)
+                factor = -factor;
+            factors.push_back(factor);
+            listed.push_back(factor);
+            expected *= factor;
+        }
+        assert(product(factors) == expected && "Product tree test failed!");
+        assert(product(factors, 1 + i % 4) == expected && "Threaded product tree test failed!");
+        assert(product(listed) == expected && "Product of range test failed!");
+        total_tests += 3;
+    }
+
+    std::cout << "Combinatorics tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests binary splitting against direct summation and known digits of e and pi.
+ *
+ * Logs results to "unit_test_series.log".
+ */
+void series_test()
+{
+    std::ofstream logFile("./unit_test_series.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing random rational series against direct summation" << '\n';
+    for (uint64_t i = 0; i < 50; i++)
+    {
+        std::vector<int64_t> p_values(60);
+        std::vector<int64_t> q_values(60);
+        std::vector<int64_t> a_values(60);
+        for (size_t n = 0; n < 60; n++)
+        {
+            p_values[n] = static_cast<int64_t>(mt64() % 2000001) - 1000000;
+            q_values[n] = static_cast<int64_t>(mt64() % 1000000) + 1;
+            a_values[n] = static_cast<int64_t>(mt64() % 2001) - 1000;
+        }
+        auto p = [&p_values](uint64_t n)
+        { return p_values[n]; };
+        auto q = [&q_values](uint64_t n)
+        { return q_values[n]; };
+        auto a = [&a_values](uint64_t n)
+        { return a_values[n]; };
+        uint64_t begin = mt64() % 20;
+        uint64_t end = begin + mt64() % 40;
+
+        // T = sum a(n) p(begin) ... p(n) q(n + 1) ... q(end - 1)
+        bigint expected_p(1);
+        bigint expected_q(1);
+        bigint expected_t(0);
+        for (uint64_t n = begin; n < end; n++)
+        {
+            expected_p *= bigint(p(n));
+            expected_q *= bigint(q(n));
+            expected_t = expected_t * bigint(q(n)) + expected_p * bigint(a(n));
+        }
+        std::tuple<bigint, bigint, bigint> result = binary_split(begin, end, p, q, a, 1 + i % 4);
+        assert(std::get<0>(result) == expected_p && "Series P test failed!");
+        assert(std::get<1>(result) == expected_q && "Series Q test failed!");
+        assert(std::get<2>(result) == expected_t && "Series T test failed!");
+        total_tests += 3;
+    }
+
+    std::cout << "Testing digits of e" << '\n';
+    // e - 1 = sum 1 / n! for n >= 1: p(n) = 1, q(n) = n, a(n) = 1
+    auto one = [](uint64_t)
+    { return 1; };
+    auto index = [](uint64_t n)
+    { return static_cast<int64_t>(n); };
+    std::tuple<bigint, bigint, bigint> e = binary_split(1, 60, one, index, one);
+    bigint e_digits = bigint_divisor(std::get<1>(e)).div(pow(bigint(10), 49) * (std::get<1>(e) + std::get<2>(e)));
+    assert(e_digits == bigint("27182818284590452353602874713526624977572470936999") && "Digits of e test failed!");
+    total_tests++;
+
+    std::cout << "Testing digits of pi with the Chudnovsky series" << '\n';
+    // 1 / pi = 12 / 640320^(3/2) * sum (-1)^n (6n)! (13591409 + 545140134 n) / ((3n)! (n!)^3 640320^(3n))
+    auto chudnovsky_p = [](uint64_t n)
+    { return -static_cast<int64_t>((6 * n - 5) * (2 * n - 1) * (6 * n - 1)); };
+    auto chudnovsky_q = [](uint64_t n)
+    { return bigint(10939058860032000) * bigint(static_cast<int64_t>(n * n * n)); };
+    auto chudnovsky_a = [](uint64_t n)
+    { return static_cast<int64_t>(13591409 + 545140134 * n); };
+    std::tuple<bigint, bigint, bigint> pi = binary_split(1, 10, chudnovsky_p, chudnovsky_q, chudnovsky_a, 2);
+    bigint pi_q = std::get<1>(pi);
+    bigint pi_digits = bigint_divisor(pi_q * bigint(13591409) + std::get<2>(pi)).div(isqrt(pow(bigint(10), 98) * bigint(10005)) * pi_q * bigint(426880));
+    assert(pi_digits == bigint("31415926535897932384626433832795028841971693993751") && "Digits of pi test failed!");
+    total_tests++;
+
+    std::cout << "Series tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+#ifdef BIGINT_INSTRUMENT
+static uint64_t trace_begins = 0;
+static uint64_t trace_ends = 0;
+static uint64_t trace_depth = 0;
+static uint64_t trace_max_depth = 0;
+
+/**
+ * @brief Trace hook that checks begin/end events nest properly.
+ *
+ */
+void trace_hook(const char *operation, uint64_t, bool begin)
+{
+    assert(operation != nullptr && "Trace operation name test failed!");
+    if (begin)
+    {
+        trace_begins++;
+        trace_max_depth = std::max(trace_max_depth, ++trace_depth);
+    }
+    else
+    {
+        assert(trace_depth > 0 && "Trace nesting test failed!");
+        trace_ends++;
+        trace_depth--;
+    }
+}
+#endif
+
+/**
+ * @brief Tests residue number system arithmetic and reconstruction.
+ *
+ * Logs results to "unit_test_rns.log".
+ */
+void rns_test()
+{
+    std::ofstream logFile("./unit_test_rns.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+    auto random_bigint = [&mt64](size_t max_digits)
+    {
+        std::string s = mt64() % 2 ? "-" : "";
+        size_t len = 1 + mt64() % max_digits;
+        s += static_cast<char>('1' + mt64() % 9);
+        for (size_t i = 1; i < len; i++)
+        {
+            s += static_cast<char>('0' + mt64() % 10);
+        }
+        return mt64() % 16 == 0 ? bigint(0) : bigint(s);
+    };
+
+    std::cout << "Testing the moduli" << '\n';
+    bigint_rns basis(bigint(0), 2000);
+    const std::vector<uint32_t> &moduli = basis.get_moduli();
+    assert(moduli.size() == basis.size() && basis.bits() == 2000 && "Basis size test failed!");
+    for (size_t i = 0; i < moduli.size(); i++)
+    {
+        assert(moduli[i] > (uint32_t(1) << 30) && (i == 0 || moduli[i] < moduli[i - 1]) && "Moduli order test failed!");
+        assert(next_prime(bigint(static_cast<int64_t>(moduli[i]) - 1)) == bigint(static_cast<int64_t>(moduli[i])) && "Moduli primality test failed!");
+        total_tests += 2;
+    }
+
+    std::cout << "Testing round trips" << '\n';
+    for (size_t i = 0; i < 200; i++)
+    {
+        bigint value = random_bigint(600);
+        assert(bigint_rns(value, basis, 1 + i % 4).to_bigint(1 + i % 3) == value && "RNS round trip test failed!");
+        total_tests++;
+    }
+    assert(bigint_rns(bigint("-0"), basis).to_bigint() == bigint(0) && "RNS zero test failed!");
+    total_tests++;
+
+    std::cout << "Testing arithmetic chains against bigint" << '\n';
+    for (size_t i = 0; i < 100; i++)
+    {
+        size_t threads = 1 + i % 4;
+        bigint a = random_bigint(100);
+        bigint b = random_bigint(100);
+        bigint c = random_bigint(100);
+        bigint_rns x(a, basis, threads);
+        bigint_rns y(b, basis, threads);
+        bigint_rns z(c, basis, threads);
+        bigint expected = a * b * c - a * a + (b - c) * c - a;
+        bigint_rns result = x.mul(y, threads).mul(z, threads).sub(x * x, threads).add((y - z) * z, threads) - x;
+        assert(result.to_bigint(threads) == expected && "RNS chain test failed!");
+        assert(result == bigint_rns(expected, basis) && "RNS equality test failed!");
+        assert((-result).to_bigint() == -expected && "RNS negation test failed!");
+        x += y;
+        x -= z;
+        x *= y;
+        assert(x.to_bigint() == (a + b - c) * b && "RNS compound assignment test failed!");
+        total_tests += 4;
+    }
+
+    std::cout << "Testing intermediate values beyond the bound" << '\n';
+    bigint_rns small(bigint(0), 100);
+    for (size_t i = 0; i < 50; i++)
+    {
+        bigint a = random_bigint(200);
+        bigint b = random_bigint(25);
+        bigint_rns x(a, small);
+        bigint_rns power = x * x * x * x;
+        assert((power - power + bigint_rns(b, small)).to_bigint() == b && "RNS wrap-around test failed!");
+        total_tests++;
+    }
+
+    std::cout << "Testing mismatched bases" << '\n';
+    bool thrown = false;
+    try
+    {
+        basis.add(small);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "RNS basis mismatch test failed!");
+    assert(bigint_rns(bigint(7), 2000) == bigint_rns(bigint(7), basis) && "RNS equal basis test failed!");
+    total_tests += 2;
+
+    std::cout << "RNS tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests `random_bits`, `random_below` and `random_range`.
+ *
+ * Logs results to "unit_test_random.log".
+ */
+void random_test()
+{
+    std::ofstream logFile("./unit_test_random.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+    std::mt19937 mt32(rd());
+    std::minstd_rand minstd(rd());
+
+    std::cout << "Testing ranges" << '\n';
+    for (uint64_t bits = 0; bits < 300; bits += 7)
+    {
+        bigint limit = pow(bigint(2), bits);
+        bigint a = random_bits(bits, mt64);
+        bigint b = random_bits(bits, minstd);
+        assert(bigint(0) <= a && a < limit && bigint(0) <= b && b < limit && "random_bits range test failed!");
+        bigint bound = limit + bigint(static_cast<int64_t>(bits));
+        bigint c = random_below(bound, mt32);
+        assert(bigint(0) <= c && c < bound && "random_below range test failed!");
+        bigint low = -limit;
+        bigint d = random_range(low, bound, mt64);
+        assert(low <= d && d <= bound && "random_range range test failed!");
+        total_tests += 3;
+    }
+    for (uint64_t i = 0; i < 100; i++)
+    {
+        assert(random_below(bigint(1), mt64) == bigint(0) && "random_below one test failed!");
+        assert(random_range(bigint(-5), bigint(-5), minstd) == bigint(-5) && "random_range single value test failed!");
+        total_tests += 2;
+    }
+
+    std::cout << "Testing uniformity" << '\n';
+    // counts of 7000 draws over 7 values stay within 20% of 1000 with overwhelming probability
+    std::vector<uint64_t> counts(7, 0);
+    for (uint64_t i = 0; i < 7000; i++)
+    {
+        bigint value = random_range(bigint(-3), bigint(3), mt32) + bigint(3);
+        for (int64_t v = 0; v < 7; v++)
+        {
+            if (value == bigint(v))
+                counts[static_cast<size_t>(v)]++;
+        }
+    }
+    for (uint64_t count : counts)
+    {
+        assert(count > 800 && count < 1200 && "random_range uniformity test failed!");
+        total_tests++;
+    }
+    // the top digit of values below 3 * 10^40 takes 0, 1 and 2 equally often
+    std::vector<uint64_t> top(3, 0);
+    bigint bound = bigint(3) * pow(bigint(10), 40);
+    bigint unit = pow(bigint(10), 40);
+    for (uint64_t i = 0; i < 3000; i++)
+    {
+        bigint value = random_below(bound, mt64);
+        top[value < unit ? 0 : value < unit + unit ? 1 : 2]++;
+    }
+    for (uint64_t count : top)
+    {
+        assert(count > 800 && count < 1200 && "random_below uniformity test failed!");
+        total_tests++;
+    }
+    // every bit of random_bits is set about half of the time
+    std::vector<uint64_t> ones(40, 0);
+    for (uint64_t i = 0; i < 2000; i++)
+    {
+        bigint value = random_bits(40, minstd);
+        for (uint64_t bit = 0; bit < 40; bit++)
+        {
+            ones[bit] += value.test_bit(bit);
+        }
+    }
+    for (uint64_t count : ones)
+    {
+        assert(count > 800 && count < 1200 && "random_bits uniformity test failed!");
+        total_tests++;
+    }
+
+    std::cout << "Testing invalid arguments" << '\n';
+    bool thrown = false;
+    try
+    {
+        random_below(bigint(0), mt64);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "random_below bound test failed!");
+    thrown = false;
+    try
+    {
+        random_range(bigint(2), bigint(1), mt64);
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "random_range empty test failed!");
+    total_tests += 2;
+
+    std::cout << "Random tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests `divexact`, `divisible_by` and `divisible_by_2exp`.
+ *
+ * Logs results to "unit_test_divexact.log".
+ */
+void divexact_test()
+{
+    std::ofstream logFile("./unit_test_divexact.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing exact division" << '\n';
+    for (uint64_t i = 0; i < 500; i++)
+    {
+        bigint q = random_bits(mt64() % 600, mt64);
+        bigint d = random_bits(mt64() % 600 + 1, mt64) + bigint(1);
+        // factors of 2, 5 and 10 on both sides exercise the stripping before the Hensel loop
+        d *= pow(bigint(2), mt64() % 40) * pow(bigint(5), mt64() % 40);
+        q *= pow(bigint(10), mt64() % 20);
+        if (mt64() % 2)
+            q = -q;
+        if (mt64() % 2)
+            d = -d;
+        bigint a = q * d;
+        assert(divexact(a, d) == q && "divexact test failed!");
+        assert(divisible_by(a, d) && "divisible_by multiple test failed!");
+        assert(divisible_by(a + bigint(1), d) == (d == bigint(1) || d == bigint(-1)) && "divisible_by non-multiple test failed!");
+        total_tests += 3;
+    }
+    // quotients of more than 32 limbs whose divisor is long enough take the split path
+    for (uint64_t i = 0; i < 100; i++)
+    {
+        bigint q = random_bits(mt64() % 8000 + 1000, mt64);
+        bigint d = random_bits(mt64() % 8000 + 1, mt64) + bigint(1);
+        d *= pow(bigint(2), mt64() % 40);
+        if (mt64() % 2)
+            q = -q;
+        bigint a = q * d;
+        assert(divexact(a, d) == q && "Long divexact test failed!");
+        assert(divisible_by(a, d) && "Long divisible_by multiple test failed!");
+        bigint near = a + random_bits(mt64() % 8000, mt64);
+        assert(divisible_by(near, d) == (bigint_divisor(d).mod(near) == bigint(0)) && "Long divisible_by test failed!");
+        total_tests += 3;
+    }
+    assert(divexact(bigint(0), bigint(-7)) == bigint(0) && "divexact zero test failed!");
+    assert(divexact(bigint("-123456789012345678901234567890"), bigint(1)) == bigint("-123456789012345678901234567890") && "divexact one test failed!");
+    assert(divexact(bigint("1000000000000000000000"), bigint("1000000000000000000000")) == bigint(1) && "divexact self test failed!");
+    assert(divisible_by(bigint(0), bigint(3)) && "divisible_by zero test failed!");
+    assert(!divisible_by(bigint(5), bigint(10)) && "divisible_by smaller test failed!");
+    assert(!divisible_by(bigint("1000000000000000000000000000000000001"), bigint(5)) && "divisible_by last digit test failed!");
+    assert(divisible_by(bigint("-3000000000000000000000000000000000000"), bigint("-3000000000000")) && "divisible_by sign test failed!");
+    total_tests += 7;
+
+    std::cout << "Testing powers of two" << '\n';
+    for (uint64_t i = 0; i < 200; i++)
+    {
+        uint64_t k = mt64() % 200;
+        bigint a = random_bits(mt64() % 300, mt64) * pow(bigint(2), mt64() % 200);
+        if (mt64() % 2)
+            a = -a;
+        assert(divisible_by_2exp(a, k) == (bigint_divisor(pow(bigint(2), k)).mod(a) == bigint(0)) && "divisible_by_2exp test failed!");
+        total_tests++;
+    }
+    assert(divisible_by_2exp(bigint(0), 1000) && "divisible_by_2exp zero test failed!");
+    assert(divisible_by_2exp(bigint(7), 0) && "divisible_by_2exp exponent zero test failed!");
+    assert(!divisible_by_2exp(bigint(1024), 11) && divisible_by_2exp(bigint(-1024), 10) && "divisible_by_2exp boundary test failed!");
+    total_tests += 3;
+
+    std::cout << "Testing invalid arguments" << '\n';
+    bool thrown = false;
+    try
+    {
+        divexact(bigint(10), bigint(0));
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "divexact zero divisor test failed!");
+    thrown = false;
+    try
+    {
+        divisible_by(bigint(10), bigint(0));
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "divisible_by zero divisor test failed!");
+    total_tests += 2;
+
+    std::cout << "Exact division tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests the conversions to and from machine types and the size estimates.
+ *
+ * Logs results to "unit_test_conversion.log".
+ */
+void conversion_test()
+{
+    std::ofstream logFile("./unit_test_conversion.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+    auto printed = [](const bigint &x)
+    {
+        std::ostringstream os;
+        os << x;
+        return os.str();
+    };
+
+    std::cout << "Testing floating-point conversions" << '\n';
+    for (uint64_t i = 0; i < 2000; i++)
+    {
+        bigint x = random_bits(mt64() % 1100, mt64);
+        if (mt64() % 2)
+            x = -x;
+        std::string s = printed(x);
+        assert(x.to_double() == std::strtod(s.c_str(), nullptr) && "to_double test failed!");
+        assert(x.to_long_double() == std::strtold(s.c_str(), nullptr) && "to_long_double test failed!");
+        uint64_t digits = s.size() - (s[0] == '-' ? 1 : 0);
+        assert(x.decimal_digit_count() == digits && "decimal_digit_count test failed!");
+        if (x != bigint(0) && digits < 300)
+            assert(std::fabs(x.log2() - std::log2(std::fabs(x.to_double()))) < 1e-9 && "log2 test failed!");
+        total_tests += 4;
+    }
+    for (uint64_t k = 54; k < 1030; k += 7)
+    {
+        bigint power = pow(bigint(2), k);
+        // the midpoint between two doubles, just above it, and the midpoint above an odd mantissa
+        std::vector<bigint> values = {power - bigint(1), power, power + bigint(1), power + pow(bigint(2), k - 53), power + pow(bigint(2), k - 53) + bigint(1), power + pow(bigint(2), k - 52) + pow(bigint(2), k - 53)};
+        for (const bigint &x : values)
+        {
+            assert(x.to_double() == std::strtod(printed(x).c_str(), nullptr) && "to_double rounding test failed!");
+            total_tests++;
+        }
+        assert(power.bit_length() == k + 1 && (power - bigint(1)).bit_length() == k && "bit_length power test failed!");
+        total_tests++;
+    }
+    assert(bigint(0).to_double() == 0 && !std::signbit(bigint("-0").to_double()) && "to_double zero test failed!");
+    assert(pow(bigint(10), 400).to_double() == std::numeric_limits<double>::infinity() && "to_double overflow test failed!");
+    assert(-pow(bigint(10), 309).to_double() == -std::numeric_limits<double>::infinity() && "to_double negative overflow test failed!");
+    assert(bigint(0).decimal_digit_count() == 1 && bigint(0).log10() == -std::numeric_limits<double>::infinity() && "Zero estimate test failed!");
+    total_tests += 4;
+
+    std::cout << "Testing from_double" << '\n';
+    for (uint64_t i = 0; i < 2000; i++)
+    {
+        uint64_t bits = mt64();
+        double x = 0;
+        std::memcpy(&x, &bits, sizeof(x));
+        if (!std::isfinite(x))
+            continue;
+        assert(bigint::from_double(x).to_double() == std::trunc(x) && "from_double round trip test failed!");
+        total_tests++;
+    }
+    assert(bigint::from_double(-2.75) == bigint(-2) && bigint::from_double(1e20) == bigint("100000000000000000000") && "from_double test failed!");
+    total_tests++;
+
+    std::cout << "Testing machine integers" << '\n';
+    for (int64_t value : {int64_t(0), int64_t(-1), std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()})
+    {
+        assert(bigint(value).fits_int64() && bigint(value).to_int64() == value && "to_int64 test failed!");
+        total_tests++;
+    }
+    bigint above("9223372036854775808");
+    assert(!above.fits_int64() && (-above).fits_int64() && !(-above - bigint(1)).fits_int64() && "fits_int64 boundary test failed!");
+    assert(bigint("18446744073709551615").to_uint64() == std::numeric_limits<uint64_t>::max() && "to_uint64 test failed!");
+    assert(!bigint("000018446744073709551615").fits_int64() && bigint("-0").to_uint64() == 0 && "Leading zero and negative zero test failed!");
+    total_tests += 3;
+    for (const char *s : {"18446744073709551616", "-1", "100000000000000000000000"})
+    {
+        bool thrown = false;
+        try
+        {
+            bigint(s).to_uint64();
+        }
+        catch (const std::invalid_argument &)
+        {
+            thrown = true;
+        }
+        assert(thrown && "to_uint64 range test failed!");
+        total_tests++;
+    }
+    bool thrown = false;
+    try
+    {
+        above.to_int64();
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "to_int64 range test failed!");
+    thrown = false;
+    try
+    {
+        bigint::from_double(std::numeric_limits<double>::quiet_NaN());
+    }
+    catch (const std::invalid_argument &)
+    {
+        thrown = true;
+    }
+    assert(thrown && "from_double NaN test failed!");
+    total_tests += 2;
+
+    std::cout << "Conversion tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests `hash64`, `hash128` and `std::hash<bigint>`.
+ *
+ * Logs results to "unit_test_hash.log".
+ */
+void hash_test()
+{
+    std::ofstream logFile("./unit_test_hash.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+    std::random_device rd;
+    std::mt19937_64 mt64(rd());
+
+    std::cout << "Testing that equal values hash equally" << '\n';
+    // a moved-from value is 0
+    bigint moved(7);
+    bigint taker(std::move(moved));
+    std::vector<std::pair<bigint, bigint>> equal = {
+        {bigint("0"), bigint(0)},
+        {bigint("-0"), bigint("000")},
+        {bigint("000123456789"), bigint(123456789)},
+        {bigint("-98765432109876543210"), bigint("-98765432109876543209") - bigint(1)},
+        {pow(bigint(2), 200), bigint(1) << 200},
+        {bigint(5) - bigint(5), bigint()},
+        {moved, bigint(0)},
+    };
+    for (const std::pair<bigint, bigint> &values : equal)
+    {
+        assert(values.first.hash64() == values.second.hash64() && "Equal hash64 test failed!");
+        assert(values.first.hash128() == values.second.hash128() && "Equal hash128 test failed!");
+        assert(std::hash<bigint>()(values.first) == std::hash<bigint>()(values.second) && "Equal std::hash test failed!");
+        total_tests += 3;
+    }
+
+    std::cout << "Testing pinned hash values" << '\n';
+    // fixed values keep the hash stable across platforms, storage modes and releases
+    assert(bigint(0).hash64() == 0xef46db3751d8e999ULL && "Pinned hash64 test failed!");
+    assert(bigint(1).hash64() == 0x4843673b0c8356bfULL && "Pinned hash64 test failed!");
+    assert(bigint(-1).hash64() == 0x96000471d5ea97eaULL && "Pinned hash64 test failed!");
+    assert(bigint("12345678901234567890123456789").hash64(42) == 0x9403f3f9a703fe51ULL && "Pinned seeded hash64 test failed!");
+    std::pair<uint64_t, uint64_t> pinned = bigint("12345678901234567890123456789").hash128();
+    assert(pinned.first == 0x8b2a3007cff388bdULL && pinned.second == 0xae6f8541f8e6d161ULL && "Pinned hash128 test failed!");
+    total_tests += 5;
+
+    std::cout << "Testing that signs, lengths and seeds change the hash" << '\n';
+    assert(bigint(7).hash64() != bigint(-7).hash64() && "Sign hash test failed!");
+    assert(bigint(1).hash64() != bigint(10).hash64() && "Length hash test failed!");
+    assert(bigint("1000000000000000").hash64() != bigint("10000000000000000").hash64() && "Word boundary hash test failed!");
+    assert(bigint(7).hash64(1) != bigint(7).hash64(2) && "Seed hash test failed!");
+    assert(bigint(7).hash128().first != bigint(7).hash128().second && "Hash128 lane test failed!");
+    total_tests += 5;
+
+    std::cout << "Testing for collisions among random and consecutive values" << '\n';
+    std::unordered_set<uint64_t> hashes64;
+    std::set<std::pair<uint64_t, uint64_t>> hashes128;
+    std::unordered_set<bigint> values;
+    for (uint64_t i = 0; i < 20000; i++)
+    {
+        bigint value = i % 2 == 0 ? bigint(static_cast<int64_t>(i) - 10000) : bigint(std::to_string(mt64()) + std::to_string(mt64()) + std::to_string(i));
+        bool inserted = values.insert(value).second;
+        assert(hashes64.insert(value.hash64()).second == inserted && "Hash64 collision test failed!");
+        assert(hashes128.insert(value.hash128()).second == inserted && "Hash128 collision test failed!");
+        total_tests += 2;
+    }
+
+    std::cout << "Testing bigints as unordered_map keys" << '\n';
+    std::unordered_map<bigint, uint64_t> memo;
+    for (uint64_t n = 0; n <= 200; n++)
+    {
+        memo[factorial(n)] = n;
+    }
+    for (uint64_t n = 0; n <= 200; n++)
+    {
+        assert((n < 2 || memo.at(factorial(n)) == n) && "Unordered map test failed!");
+        total_tests++;
+    }
+    assert(memo.size() == 200 && memo.at(bigint(1)) == 1 && "Unordered map size test failed!");
+    total_tests++;
+
+#if BIGINT_HAS_CONSTEXPR
+    static_assert(bigint("-123456789012345678901234567890").hash64() == bigint("-123456789012345678901234567890").hash64(), "Constexpr hash test failed!");
+#endif
+
+    std::cout << "Hash tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
+/**
+ * @brief Tests the operation counters, size histograms and trace hooks.
+ *
+ * With `-DBIGINT_INSTRUMENT` checks the collected counts; otherwise checks that the hooks compile away.
+ * Logs results to "unit_test_instrument.log".
+ */
+void instrument_test()
+{
+    std::ofstream logFile("./unit_test_instrument.log");
+    std::cout.rdbuf(logFile.rdbuf());
+    if (!logFile.is_open())
+    {
+        std::cerr << "Error: Unable to open log file!" << std::endl;
+        EXIT_FAILURE;
+    }
+
+    uint64_t total_tests = 0;
+#ifdef BIGINT_INSTRUMENT
+    const bigint small = pow(bigint(7), 40);
+    const bigint large = pow(bigint(3), 4000);
+
+    std::cout << "Testing call counts and size histograms" << '\n';
+    bigint_instrument::reset();
+    bigint sum = small + small;
+    bigint_instrument::totals totals = bigint_instrument::collect();
+    assert(totals.calls[bigint_instrument::add] == 1 && "Add count test failed!");
+    assert(totals.sizes[bigint_instrument::add][6] == 1 && "Add histogram test failed!");
+    total_tests += 2;
+
+    bigint_instrument::reset();
+    bigint product = small * small;
+    totals = bigint_instrument::collect();
+    assert(totals.calls[bigint_instrument::mul] == 1 && "Mul count test failed!");
+    assert(totals.calls[bigint_instrument::mul_schoolbook] == 1 && "Schoolbook tier test failed!");
+    assert(totals.calls[bigint_instrument::mul_karatsuba] == 0 && "Schoolbook tier test failed!");
+    total_tests += 3;
+
+    bigint_instrument::reset();
+    product = large * (large + bigint(1));
+    totals = bigint_instrument::collect();
+    assert(totals.calls[bigint_instrument::mul] == 1 && "Mul count test failed!");
+    assert(totals.calls[bigint_instrument::mul_karatsuba] > 0 && "Karatsuba tier test failed!");
+    assert(totals.calls[bigint_instrument::mul_schoolbook] > 0 && "Karatsuba leaf test failed!");
+    assert(totals.sizes[bigint_instrument::mul][11] == 1 && "Mul histogram test failed!");
+    total_tests += 4;
+
+    std::cout << "Testing copy byte counters" << '\n';
+    bigint_instrument::reset();
+    bigint copy = large; // 1909 digits
+    totals = bigint_instrument::collect();
+    assert(totals.calls[bigint_instrument::copy] == 1 && "Copy count test failed!");
+#ifndef BIGINT_SHARED_STORAGE
+    assert(totals.bytes_copied == 1909 && "Bytes copied test failed!");
+    assert(totals.bytes_allocated == 1909 && "Bytes allocated test failed!");
+#else
+    assert(totals.bytes_copied == 0 && "Shared copy test failed!");
+#endif
+    total_tests += 2;
+
+    std::cout << "Testing result byte counters" << '\n';
+    bigint_instrument::reset();
+    bigint doubled = large + large; // 1909 digits
+    totals = bigint_instrument::collect();
+    assert(totals.bytes_allocated == 1909 && totals.bytes_copied == 0 && "Sum bytes test failed!");
+    bigint_instrument::reset();
+    bigint squared = small * small;
+    totals = bigint_instrument::collect();
+    assert(totals.bytes_allocated == squared.decimal_digit_count() && "Product bytes test failed!");
+    total_tests += 2;
+
+    std::cout << "Testing counters merged across threads" << '\n';
+    bigint_instrument::reset();
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < 4; t++)
+    {
+        workers.emplace_back([&small]()
+                             {
+                                 bigint local(0);
+                                 for (size_t i = 0; i < 100; i++)
+                                 {
+                                     local = local + small;
+                                 } });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    totals = bigint_instrument::collect();
+    assert(totals.calls[bigint_instrument::add] == 400 && "Thread merge test failed!");
+    total_tests++;
+    totals.print(std::cout);
+
+    std::cout << "Testing trace hooks" << '\n';
+    bigint_instrument::set_trace(trace_hook);
+    assert(bigint_instrument::trace() == trace_hook && "Trace install test failed!");
+    bigint power = pow(large, 3);
+    bigint_instrument::set_trace(nullptr);
+    assert(trace_begins > 0 && trace_begins == trace_ends && trace_depth == 0 && "Trace pairing test failed!");
+    assert(trace_max_depth >= 2 && "Trace nesting test failed!");
+    total_tests += 3;
+
+    std::cout << "Testing reset" << '\n';
+    bigint_instrument::reset();
+    totals = bigint_instrument::collect();
+    for (size_t e = 0; e < bigint_instrument::event_count; e++)
+    {
+        assert(totals.calls[e] == 0 && "Reset test failed!");
+    }
+    assert(totals.bytes_copied == 0 && totals.bytes_allocated == 0 && "Reset bytes test failed!");
+    total_tests += 2;
+    (void)sum;
+    (void)copy;
+    (void)doubled;
+    (void)power;
+#else
+    std::cout << "Testing that the hooks compile away" << '\n';
+    BIGINT_RECORD(add, 1);
+    BIGINT_RECORD_BYTES(1, 1);
+    BIGINT_SPAN(mul, 1);
+    assert(bigint(2) + bigint(2) == bigint(4) && "Disabled instrumentation test failed!");
+    total_tests++;
+#endif
+
+    std::cout << "Instrument tests passed: " << total_tests << '\n';
+    std::cout << "------------------------------------------------" << std::endl;
+
+    logFile.close();
+}
+
 /**
  * @brief Main entry point for running all unit tests.
  *
@@ -480,6 +2568,27 @@ int main()
         unit_test_2();
         edge_test();
         exception_test();
+        constexpr_test();
+        expression_test();
+        fma_test();
+        accumulator_test();
+        pow_test();
+        modular_test();
+        divisor_test();
+        gcd_test();
+        root_test();
+        prime_test();
+        bitwise_test();
+        storage_test();
+        batch_test();
+        combinatorics_test();
+        series_test();
+        instrument_test();
+        hash_test();
+        rns_test();
+        random_test();
+        divexact_test();
+        conversion_test();
 
         std::cout.rdbuf(originalCoutBuffer);
     }
@@ -0,0 +1,240 @@
+/**
+ * @file tune.cpp
+ * @brief Measures the Karatsuba crossovers of `bigint` on the host and writes them to a thresholds header.
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * At each operand size the top level of a multiplication or squaring is timed once with
+ * schoolbook columns and once with one Karatsuba split over schoolbook halves. The threshold is
+ * the first size from which the split wins at several consecutive sizes. The result is written as
+ * `#define`s that `bigint.hpp` picks up when the file sits next to it.
+ *
+ */
+#define BIGINT_TUNE
+#include "bigint.hpp"
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <random>
+
+/**
+ * @brief Command-line settings of a tuning run.
+ *
+ */
+struct tune_options
+{
+    uint64_t min_digits = 16;                          ///< Smallest operand size tried.
+    uint64_t max_digits = 2048;                        ///< Largest operand size tried.
+    double step = 1.1;                                 ///< Ratio between consecutive sizes.
+    double min_time = 0.02;                            ///< Seconds to repeat each timing for.
+    uint64_t confirm = 3;                              ///< Consecutive sizes the split must win at.
+    std::string output_path = "bigint_thresholds.hpp"; ///< Generated header.
+};
+
+/**
+ * @brief Crossover search for one kernel.
+ *
+ */
+struct tune_kernel
+{
+    std::string name;                       ///< Name used in the output.
+    std::string macro;                      ///< Threshold macro written to the header.
+    size_t &threshold;                      ///< Run-time threshold switched during the search.
+    std::function<void(uint64_t)> prepare;  ///< Draws operands with the given number of digits.
+    std::function<void(bigint &)> kernel;   ///< One call of the operation; stores a result in the sink.
+};
+
+/**
+ * @brief Random decimal string without a leading zero.
+ *
+ * @param digits Number of digits.
+ * @param mt64 Random engine.
+ * @return The string.
+ */
+std::string random_digits(uint64_t digits, std::mt19937_64 &mt64)
+{
+    std::string s(digits, '0');
+    for (uint64_t i = 0; i < digits; i++)
+    {
+        s[i] = static_cast<char>('0' + mt64() % 10);
+    }
+    s[0] = static_cast<char>('1' + mt64() % 9);
+    return s;
+}
+
+/**
+ * @brief Times one call of a kernel.
+ *
+ * The kernel is repeated for `min_time` seconds five times, and the fastest mean is kept so that
+ * interruptions by other processes do not move the crossover.
+ *
+ * @param kernel The kernel.
+ * @param min_time Seconds to repeat each of the five rounds for.
+ * @return Seconds per call.
+ */
+double time_per_call(const std::function<void(bigint &)> &kernel, double min_time)
+{
+    bigint sink;
+    auto start = std::chrono::steady_clock::now();
+    kernel(sink);
+    double once = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t iterations = static_cast<uint64_t>(min_time / 5 / std::max(once, 1e-9)) + 1;
+
+    double best = std::numeric_limits<double>::max();
+    for (int round = 0; round < 5; round++)
+    {
+        start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            kernel(sink);
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, elapsed / static_cast<double>(iterations));
+    }
+    return best;
+}
+
+/**
+ * @brief Finds the crossover of one kernel.
+ *
+ * At size `n` the threshold is set to `n + 1` to time schoolbook, and to `n` to time one Karatsuba
+ * split whose halves fall back to schoolbook. The threshold is left at the result.
+ *
+ * @param kernel The kernel.
+ * @param options The settings.
+ * @return The first size of a run of `confirm` sizes where the split is faster, or `max_digits` if there is none.
+ */
+uint64_t find_crossover(tune_kernel &kernel, const tune_options &options)
+{
+    std::cout << kernel.name << '\n';
+    std::cout << "    digits  schoolbook ns  karatsuba ns\n";
+    uint64_t candidate = 0;
+    uint64_t wins = 0;
+    for (uint64_t n = options.min_digits; n <= options.max_digits; n = std::max(n + 1, static_cast<uint64_t>(static_cast<double>(n) * options.step)))
+    {
+        kernel.prepare(n);
+        kernel.threshold = static_cast<size_t>(n + 1);
+        double schoolbook = time_per_call(kernel.kernel, options.min_time);
+        kernel.threshold = static_cast<size_t>(n);
+        double karatsuba = time_per_call(kernel.kernel, options.min_time);
+        std::cout << std::string(10 - std::min<size_t>(10, std::to_string(n).size()), ' ') << n << "  " << schoolbook * 1e9 << "  " << karatsuba * 1e9 << '\n';
+
+        if (karatsuba < schoolbook)
+        {
+            if (wins++ == 0)
+                candidate = n;
+            if (wins == options.confirm)
+                break;
+        }
+        else
+            wins = 0;
+    }
+    uint64_t result = wins == options.confirm ? candidate : options.max_digits;
+    kernel.threshold = static_cast<size_t>(result);
+    std::cout << kernel.macro << " = " << result << '\n';
+    return result;
+}
+
+/**
+ * @brief Writes the thresholds header.
+ *
+ * @param path Output file.
+ * @param kernels The tuned kernels, with their thresholds set.
+ * @throws std::invalid_argument if the file cannot be opened.
+ */
+void write_header(const std::string &path, const std::vector<tune_kernel> &kernels)
+{
+    std::ofstream out(path);
+    if (!out.is_open())
+        throw std::invalid_argument("tune::write_header : Unable to open " + path + ".");
+    out << "/**\n";
+    out << " * @file " << path.substr(path.find_last_of("/\\") + 1) << "\n";
+    out << " * @brief Karatsuba thresholds measured on this host by tune.cpp; regenerate instead of editing.\n";
+    out << " *\n";
+    out << " */\n";
+    for (const tune_kernel &kernel : kernels)
+    {
+        out << "#ifndef " << kernel.macro << '\n';
+        out << "#define " << kernel.macro << ' ' << kernel.threshold << '\n';
+        out << "#endif\n";
+    }
+}
+
+/**
+ * @brief Parses the command line.
+ *
+ * @param argc Number of arguments.
+ * @param argv The arguments.
+ * @return The settings.
+ * @throws std::invalid_argument for an unknown option, a missing value or a range that cannot terminate.
+ */
+tune_options parse(int argc, char **argv)
+{
+    tune_options options;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if (i + 1 >= argc)
+            throw std::invalid_argument("tune::parse : Missing value for " + option + ".");
+        std::string value = argv[++i];
+        if (option == "--min-digits")
+            options.min_digits = std::stoull(value);
+        else if (option == "--max-digits")
+            options.max_digits = std::stoull(value);
+        else if (option == "--step")
+            options.step = std::stod(value);
+        else if (option == "--min-time")
+            options.min_time = std::stod(value);
+        else if (option == "--confirm")
+            options.confirm = std::stoull(value);
+        else if (option == "--output")
+            options.output_path = value;
+        else
+            throw std::invalid_argument("tune::parse : Unknown option " + option + ".");
+    }
+    if (options.min_digits < 2 || options.max_digits < options.min_digits || options.confirm == 0)
+        throw std::invalid_argument("tune::parse : Sizes must satisfy 2 <= min-digits <= max-digits and confirm must be positive.");
+    return options;
+}
+
+/**
+ * @brief Main entry point for the tuner.
+ *
+ * @param argc Number of arguments.
+ * @param argv The arguments.
+ * @return 0 on success, 2 on invalid usage.
+ */
+int main(int argc, char **argv)
+{
+    try
+    {
+        tune_options options = parse(argc, argv);
+        std::mt19937_64 mt64(12345);
+        bigint a;
+        bigint b;
+        std::vector<tune_kernel> kernels;
+        kernels.push_back({"mul", "BIGINT_MUL_KARATSUBA_THRESHOLD", bigint_tune::mul_karatsuba(), [&](uint64_t digits)
+                           {
+                               a = bigint(random_digits(digits, mt64));
+                               b = bigint(random_digits(digits, mt64));
+                           },
+                           [&](bigint &sink)
+                           { sink = a * b; }});
+        kernels.push_back({"square", "BIGINT_SQR_KARATSUBA_THRESHOLD", bigint_tune::sqr_karatsuba(), [&](uint64_t digits)
+                           { a = bigint(random_digits(digits, mt64)); },
+                           [&](bigint &sink)
+                           { sink = a.square(); }});
+        for (tune_kernel &kernel : kernels)
+        {
+            find_crossover(kernel, options);
+        }
+        write_header(options.output_path, kernels);
+        std::cout << "Wrote " << options.output_path << '\n';
+    }
+    catch (const std::invalid_argument &e)
+    {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 2;
+    }
+    return 0;
+}